@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+#
+# Module: LINK
+#
+# File Name: link_key.py
+#
+# Description: make the internal EEPROM image (.eep , Intel HEX) with a new random key
+#              for the encrypted link of one door (program the same image in mc1 and mc2)
+#
+# Author: mahmoud Mohamed
+#
+import argparse
+import os
+import sys
+
+KEY_SIZE = 16                         # ASCON_KEY_SIZE
+EEPROM_SIZE = 512                     # E2END+1 of the ATmega16
+KEY_ADDRESS = EEPROM_SIZE - KEY_SIZE  # LINK_KEY_EEPROM_ADDRESS
+
+
+def record(address, rtype, data):
+    body = bytes([len(data), (address >> 8) & 0xFF, address & 0xFF, rtype]) + data
+    return ":%s%02X" % (body.hex().upper(), (-sum(body)) & 0xFF)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("output", help="the .eep file to write (e.g. door1_key.eep)")
+    parser.add_argument("--key", help="32 hex digits to reuse a key instead of a random one")
+    args = parser.parse_args()
+
+    key = bytes.fromhex(args.key) if args.key else os.urandom(KEY_SIZE)
+    if len(key) != KEY_SIZE or key in (b"\xff" * KEY_SIZE, b"\x00" * KEY_SIZE):
+        sys.exit("the key must be %d bytes and not all 0xFF or all 0x00" % KEY_SIZE)
+
+    # write only the key bytes , the rest of the EEPROM (password record , lockout ring) is kept
+    with open(args.output, "w") as out:
+        out.write(record(KEY_ADDRESS, 0x00, key) + "\n")
+        out.write(record(0, 0x01, b"") + "\n")
+    os.chmod(args.output, 0o600)
+
+
+if __name__ == "__main__":
+    main()
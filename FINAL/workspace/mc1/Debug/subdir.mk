@@ -4,27 +4,45 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../ascon.c \
 ../gpio.c \
 ../keypad.c \
 ../lcd.c \
+../lcd_fb.c \
+../lcd_progress.c \
+../link.c \
 ../mc_1.c \
+../timebase.c \
 ../timer0.c \
+../timestamp.c \
 ../uart.c 
 
 OBJS += \
+./ascon.o \
 ./gpio.o \
 ./keypad.o \
 ./lcd.o \
+./lcd_fb.o \
+./lcd_progress.o \
+./link.o \
 ./mc_1.o \
+./timebase.o \
 ./timer0.o \
+./timestamp.o \
 ./uart.o 
 
 C_DEPS += \
+./ascon.d \
 ./gpio.d \
 ./keypad.d \
 ./lcd.d \
+./lcd_fb.d \
+./lcd_progress.d \
+./link.d \
 ./mc_1.d \
+./timebase.d \
 ./timer0.d \
+./timestamp.d \
 ./uart.d 
 
 
@@ -32,7 +50,7 @@ C_DEPS += \
 %.o: ../%.c subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -Os -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
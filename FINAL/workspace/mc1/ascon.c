@@ -0,0 +1,238 @@
+/******************************************************************************
+ *
+ * Module: ascon
+ *
+ * File Name: ascon.c
+ *
+ * Description: Source file for the Ascon-128 authenticated encryption
+ *              (64 bit words kept as 32 bit halves for the 8 bit AVR)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"ascon.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* Ascon-128 : 128 bit key , 64 bit rate , 12 rounds for init/final and 6 rounds per block */
+#define ASCON_IV_HIGH             0x80400c06UL
+#define ASCON_RATE                8
+#define ASCON_ROUNDS_A            12
+#define ASCON_ROUNDS_B            6
+/* high/low half of a 64 bit word (h,l) rotated right by 0<n<32 , rotation by n+32 is the swap of them */
+#define ASCON_ROR_H(h,l,n)        (((h)>>(n))|((l)<<(32-(n))))
+#define ASCON_ROR_L(h,l,n)        (((l)>>(n))|((h)<<(32-(n))))
+/* substitution layer on the 5 words (same on the high and low halves) */
+#define ASCON_SBOX(x0,x1,x2,x3,x4) \
+	do{ \
+		uint32 t0,t1,t2,t3,t4; \
+		x0^=x4; x4^=x3; x2^=x1; \
+		t0=~x0&x1; t1=~x1&x2; t2=~x2&x3; t3=~x3&x4; t4=~x4&x0; \
+		x0^=t1; x1^=t2; x2^=t3; x3^=t4; x4^=t0; \
+		x1^=x0; x0^=x4; x3^=x2; x2=~x2; \
+	}while(0)
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*******************************************************************************
+ *  Structure name : s_ascon_State
+ *  Structure Description:
+ *  320 bit state : high and low 32 bits of the five 64 bit words
+ */
+typedef struct
+{
+	uint32 h[5];
+	uint32 l[5];
+}s_ascon_State;
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: Function to load 8 bytes (big endian) as a 64 bit word
+ */
+static void ASCON_load(const uint8 * bytes_ptr,uint32 * h_ptr,uint32 * l_ptr)
+{
+	*h_ptr=((uint32)bytes_ptr[0]<<24)|((uint32)bytes_ptr[1]<<16)|((uint32)bytes_ptr[2]<<8)|bytes_ptr[3];
+	*l_ptr=((uint32)bytes_ptr[4]<<24)|((uint32)bytes_ptr[5]<<16)|((uint32)bytes_ptr[6]<<8)|bytes_ptr[7];
+}
+/*
+ * Description: Function to store a 64 bit word as 8 bytes (big endian)
+ */
+static void ASCON_store(uint8 * bytes_ptr,uint32 h,uint32 l)
+{
+	uint8 i;
+	for(i=0;i<4;i++)
+	{
+		bytes_ptr[i]=(uint8)(h>>(24-8*i));
+		bytes_ptr[4+i]=(uint8)(l>>(24-8*i));
+	}
+}
+/*
+ * Description: Function to apply the last (rounds) rounds of the permutation
+ */
+static void ASCON_permute(s_ascon_State * state_ptr,uint8 rounds)
+{
+	uint32 h0=state_ptr->h[0],h1=state_ptr->h[1],h2=state_ptr->h[2],h3=state_ptr->h[3],h4=state_ptr->h[4];
+	uint32 l0=state_ptr->l[0],l1=state_ptr->l[1],l2=state_ptr->l[2],l3=state_ptr->l[3],l4=state_ptr->l[4];
+	uint32 th,tl;
+	uint8 round;
+	for(round=ASCON_ROUNDS_A-rounds;round<ASCON_ROUNDS_A;round++)
+	{
+		/* round constant 0xf0,0xe1,... in the low byte of x2 */
+		l2^=(uint8)(((0x0F-round)<<4)|round);
+		ASCON_SBOX(h0,h1,h2,h3,h4);
+		ASCON_SBOX(l0,l1,l2,l3,l4);
+		/* linear layer : x ^= (x >>> a) ^ (x >>> b) */
+		th=h0^ASCON_ROR_H(h0,l0,19)^ASCON_ROR_H(h0,l0,28);
+		tl=l0^ASCON_ROR_L(h0,l0,19)^ASCON_ROR_L(h0,l0,28);
+		h0=th; l0=tl;
+		th=h1^ASCON_ROR_L(h1,l1,29)^ASCON_ROR_L(h1,l1,7); /* 61 , 39 */
+		tl=l1^ASCON_ROR_H(h1,l1,29)^ASCON_ROR_H(h1,l1,7);
+		h1=th; l1=tl;
+		th=h2^ASCON_ROR_H(h2,l2,1)^ASCON_ROR_H(h2,l2,6);
+		tl=l2^ASCON_ROR_L(h2,l2,1)^ASCON_ROR_L(h2,l2,6);
+		h2=th; l2=tl;
+		th=h3^ASCON_ROR_H(h3,l3,10)^ASCON_ROR_H(h3,l3,17);
+		tl=l3^ASCON_ROR_L(h3,l3,10)^ASCON_ROR_L(h3,l3,17);
+		h3=th; l3=tl;
+		th=h4^ASCON_ROR_H(h4,l4,7)^ASCON_ROR_L(h4,l4,9); /* 7 , 41 */
+		tl=l4^ASCON_ROR_L(h4,l4,7)^ASCON_ROR_H(h4,l4,9);
+		h4=th; l4=tl;
+	}
+	state_ptr->h[0]=h0;state_ptr->h[1]=h1;state_ptr->h[2]=h2;state_ptr->h[3]=h3;state_ptr->h[4]=h4;
+	state_ptr->l[0]=l0;state_ptr->l[1]=l1;state_ptr->l[2]=l2;state_ptr->l[3]=l3;state_ptr->l[4]=l4;
+}
+/*
+ * Description: Function to return byte (index) (0 to 7 , big endian) of the rate word x0
+ */
+static uint8 ASCON_getByte(const s_ascon_State * state_ptr,uint8 index)
+{
+	uint32 word=(index<4)?state_ptr->h[0]:state_ptr->l[0];
+	return (uint8)(word>>(24-8*(index&3)));
+}
+/*
+ * Description: Function to xor (value) into byte (index) of the rate word x0
+ */
+static void ASCON_xorByte(s_ascon_State * state_ptr,uint8 index,uint8 value)
+{
+	uint32 word=(uint32)value<<(24-8*(index&3));
+	if(index<4)
+	{
+		state_ptr->h[0]^=word;
+	}
+	else
+	{
+		state_ptr->l[0]^=word;
+	}
+}
+/*
+ * Description: Function to initialize the state with the key and nonce then absorb the associated data
+ */
+static void ASCON_start(s_ascon_State * state_ptr,const uint8 * key_ptr,const uint8 * nonce_ptr,
+		const uint8 * ad_ptr,uint8 ad_length)
+{
+	uint32 k0h,k0l,k1h,k1l;
+	uint8 i;
+	ASCON_load(key_ptr,&k0h,&k0l);
+	ASCON_load(key_ptr+8,&k1h,&k1l);
+	state_ptr->h[0]=ASCON_IV_HIGH;
+	state_ptr->l[0]=0;
+	state_ptr->h[1]=k0h;state_ptr->l[1]=k0l;
+	state_ptr->h[2]=k1h;state_ptr->l[2]=k1l;
+	ASCON_load(nonce_ptr,&state_ptr->h[3],&state_ptr->l[3]);
+	ASCON_load(nonce_ptr+8,&state_ptr->h[4],&state_ptr->l[4]);
+	ASCON_permute(state_ptr,ASCON_ROUNDS_A);
+	state_ptr->h[3]^=k0h;state_ptr->l[3]^=k0l;
+	state_ptr->h[4]^=k1h;state_ptr->l[4]^=k1l;
+	if(ad_length!=0)
+	{
+		for(i=0;i<ad_length;i++)
+		{
+			ASCON_xorByte(state_ptr,i&(ASCON_RATE-1),ad_ptr[i]);
+			if((i&(ASCON_RATE-1))==(ASCON_RATE-1))
+			{
+				ASCON_permute(state_ptr,ASCON_ROUNDS_B);
+			}
+		}
+		ASCON_xorByte(state_ptr,ad_length&(ASCON_RATE-1),0x80);
+		ASCON_permute(state_ptr,ASCON_ROUNDS_B);
+	}
+	/* domain separation of the associated data and the message */
+	state_ptr->l[4]^=1;
+}
+/*
+ * Description: Function to pad the message , finalize and write the tag
+ */
+static void ASCON_finish(s_ascon_State * state_ptr,const uint8 * key_ptr,uint8 length,uint8 * tag_ptr)
+{
+	uint32 k0h,k0l,k1h,k1l;
+	ASCON_load(key_ptr,&k0h,&k0l);
+	ASCON_load(key_ptr+8,&k1h,&k1l);
+	ASCON_xorByte(state_ptr,length&(ASCON_RATE-1),0x80);
+	state_ptr->h[1]^=k0h;state_ptr->l[1]^=k0l;
+	state_ptr->h[2]^=k1h;state_ptr->l[2]^=k1l;
+	ASCON_permute(state_ptr,ASCON_ROUNDS_A);
+	ASCON_store(tag_ptr,state_ptr->h[3]^k0h,state_ptr->l[3]^k0l);
+	ASCON_store(tag_ptr+8,state_ptr->h[4]^k1h,state_ptr->l[4]^k1l);
+}
+/*
+ * Description: Function to encrypt (length) bytes and compute the tag
+ */
+void ASCON_encrypt(const uint8 * key_ptr,const uint8 * nonce_ptr,const uint8 * ad_ptr,uint8 ad_length,
+		const uint8 * plain_ptr,uint8 * cipher_ptr,uint8 length,uint8 * tag_ptr)
+{
+	s_ascon_State state;
+	uint8 i;
+	ASCON_start(&state,key_ptr,nonce_ptr,ad_ptr,ad_length);
+	for(i=0;i<length;i++)
+	{
+		ASCON_xorByte(&state,i&(ASCON_RATE-1),plain_ptr[i]);
+		cipher_ptr[i]=ASCON_getByte(&state,i&(ASCON_RATE-1));
+		if((i&(ASCON_RATE-1))==(ASCON_RATE-1))
+		{
+			ASCON_permute(&state,ASCON_ROUNDS_B);
+		}
+	}
+	ASCON_finish(&state,key_ptr,length,tag_ptr);
+}
+/*
+ * Description: Function to decrypt (length) bytes and check the first (tag_length) bytes of the tag
+ */
+boolean ASCON_decrypt(const uint8 * key_ptr,const uint8 * nonce_ptr,const uint8 * ad_ptr,uint8 ad_length,
+		const uint8 * cipher_ptr,uint8 * plain_ptr,uint8 length,const uint8 * tag_ptr,uint8 tag_length)
+{
+	s_ascon_State state;
+	uint8 tag[ASCON_TAG_SIZE];
+	uint8 difference=0; /*OR of the differences of the tag bytes (no exit at the first wrong byte)*/
+	uint8 cipher;
+	uint8 i;
+	ASCON_start(&state,key_ptr,nonce_ptr,ad_ptr,ad_length);
+	for(i=0;i<length;i++)
+	{
+		cipher=cipher_ptr[i];
+		plain_ptr[i]=(uint8)(ASCON_getByte(&state,i&(ASCON_RATE-1))^cipher);
+		/* the rate byte becomes the cipher byte */
+		ASCON_xorByte(&state,i&(ASCON_RATE-1),plain_ptr[i]);
+		if((i&(ASCON_RATE-1))==(ASCON_RATE-1))
+		{
+			ASCON_permute(&state,ASCON_ROUNDS_B);
+		}
+	}
+	ASCON_finish(&state,key_ptr,length,tag);
+	for(i=0;i<tag_length;i++)
+	{
+		difference|=(uint8)(tag[i]^tag_ptr[i]);
+	}
+	if(difference!=0)
+	{
+		for(i=0;i<length;i++)
+		{
+			plain_ptr[i]=0;
+		}
+		return FALSE;
+	}
+	return TRUE;
+}
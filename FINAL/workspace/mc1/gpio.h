@@ -14,6 +14,8 @@
 #define GPIO_H_
 
 #include "std_types.h"
+#include <avr/io.h> /* To use the port registers in the compile time pin access */
+#include <util/atomic.h> /* To make the masked writes interrupt safe */
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -35,6 +37,56 @@
 #define PIN6_ID                6
 #define PIN7_ID                7
 
+/*
+ * Compile time pin access : a pin is bound once to its port letter and pin number ,
+ * e.g. #define BUZZER_PIN GPIO_PIN(C,PIN7_ID) , then GPIO_PIN_HIGH(BUZZER_PIN)
+ * compiles to one sbi instruction (no port id check or switch at run time).
+ * Port and pin must be constants , use the GPIO_xxx functions for run time port/pin numbers.
+ */
+#define GPIO_PIN(port,pin)             port,pin
+
+/* registers , mask and driver port id of a port letter (e.g. GPIO_PORT_REG(C) is PORTC) */
+#define GPIO_CONCAT(a,b)               a##b
+#define GPIO_CONCAT3(a,b,c)            a##b##c
+#define GPIO_PORT_REG(port)            GPIO_CONCAT(PORT,port)
+#define GPIO_DDR_REG(port)             GPIO_CONCAT(DDR,port)
+#define GPIO_PIN_REG(port)             GPIO_CONCAT(PIN,port)
+#define GPIO_PORT_ID(port)             GPIO_CONCAT3(PORT,port,_ID)
+
+/* pin operations on a GPIO_PIN (the extra macro level splits it to port and pin) */
+#define GPIO_PIN_OUTPUT(gpio_pin)      GPIO_PIN_OUTPUT_(gpio_pin)
+#define GPIO_PIN_INPUT(gpio_pin)       GPIO_PIN_INPUT_(gpio_pin)
+#define GPIO_PIN_HIGH(gpio_pin)        GPIO_PIN_HIGH_(gpio_pin)
+#define GPIO_PIN_LOW(gpio_pin)         GPIO_PIN_LOW_(gpio_pin)
+#define GPIO_PIN_WRITE(gpio_pin,value) GPIO_PIN_WRITE_(gpio_pin,value)
+#define GPIO_PIN_READ(gpio_pin)        GPIO_PIN_READ_(gpio_pin)
+#define GPIO_PIN_MASK(gpio_pin)        GPIO_PIN_MASK_(gpio_pin)
+#define GPIO_PIN_PORT_ID(gpio_pin)     GPIO_PIN_PORT_ID_(gpio_pin)
+#define GPIO_PIN_PORT(gpio_pin)        GPIO_PIN_PORT_(gpio_pin)
+#define GPIO_PIN_NUMBER(gpio_pin)      GPIO_PIN_NUMBER_(gpio_pin)
+
+#define GPIO_PIN_OUTPUT_(port,pin)     (GPIO_DDR_REG(port) |= (uint8)(1<<(pin)))
+#define GPIO_PIN_INPUT_(port,pin)      (GPIO_DDR_REG(port) &= (uint8)~(1<<(pin)))
+#define GPIO_PIN_HIGH_(port,pin)       (GPIO_PORT_REG(port) |= (uint8)(1<<(pin)))
+#define GPIO_PIN_LOW_(port,pin)        (GPIO_PORT_REG(port) &= (uint8)~(1<<(pin)))
+#define GPIO_PIN_WRITE_(port,pin,value) \
+	((value) ? (void)GPIO_PIN_HIGH_(port,pin) : (void)GPIO_PIN_LOW_(port,pin))
+#define GPIO_PIN_READ_(port,pin)       ((GPIO_PIN_REG(port) & (uint8)(1<<(pin))) ? LOGIC_HIGH : LOGIC_LOW)
+#define GPIO_PIN_MASK_(port,pin)       ((uint8)(1<<(pin)))
+#define GPIO_PIN_PORT_ID_(port,pin)    GPIO_PORT_ID(port)
+#define GPIO_PIN_PORT_(port,pin)       port
+
+/*
+ * Compile time masked write : the mask pins of the port (or direction) register take their value bits
+ * in one interrupt safe read-modify-write , the other pins are not changed
+ * (e.g. GPIO_PORT_WRITE_MASKED(B,0x03,0x02) sets PB1 and clears PB0 at the same instruction)
+ */
+#define GPIO_REG_WRITE_MASKED(reg,mask,value) \
+	do { ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { (reg) = (uint8)(((reg) & (uint8)~(mask)) | ((value) & (mask))); } } while(0)
+#define GPIO_PORT_WRITE_MASKED(port,mask,value) GPIO_REG_WRITE_MASKED(GPIO_PORT_REG(port),mask,value)
+#define GPIO_DDR_WRITE_MASKED(port,mask,value)  GPIO_REG_WRITE_MASKED(GPIO_DDR_REG(port),mask,value)
+#define GPIO_PIN_NUMBER_(port,pin)     (pin)
+
 /*******************************************************************************
  *                               Types Declaration                             *
  *******************************************************************************/
@@ -99,4 +151,12 @@ void GPIO_writePort(uint8 port_num, uint8 value);
  */
 uint8 GPIO_readPort(uint8 port_num);
 
+/*
+ * Description :
+ * Write the value bits on the mask pins of the required port in one interrupt safe read-modify-write.
+ * The pins out of the mask are not changed.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value);
+
 #endif /* GPIO_H_ */
@@ -12,138 +12,438 @@
 #include "common_macros.h" /* To use the macros like SET_BIT */
 #include "keypad.h"
 #include "gpio.h"
+#include "timebase.h"
+#include "timestamp.h"
+#include <avr/io.h> /* To use the keypad port registers */
+#include <avr/pgmspace.h> /* To keep the keymap in flash */
+#include <avr/cpufunc.h> /* To use _NOP */
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
 
 /*******************************************************************************
- *                      Functions Prototypes(Private)                          *
+ *                           Global Variables                                  *
  *******************************************************************************/
 
+/* debounce counter of every key (counts up while pressed , down while released) */
+static uint8 g_keypad_debounce[KEYPAD_NUM_KEYS];
+/* debounced state of the keys (bitmap , see KEYPAD_BITMAP_BIT) */
+static KEYPAD_BitmapType g_keypad_state=0;
+/* last pressed key and the scans left till its next repeat event */
+static uint8 g_keypad_repeatButton=0;
+static uint8 g_keypad_repeatScans=0;
+/* key events FIFO (written by the scanner interrupt , read by the application) */
+static KEYPAD_Event g_keypad_events[KEYPAD_EVENTS_FIFO_SIZE];
+static volatile uint8 g_keypad_eventsHead=0;
+static volatile uint8 g_keypad_eventsTail=0;
+/* TRUE while the keypad is in standby (scanner doesn't touch the port) */
+static volatile boolean g_keypad_standby=FALSE;
+/* TRUE from the wake up interrupt till the first key event */
+static volatile boolean g_keypad_wakePending=FALSE;
+
+/* rows and columns ports registers and driver ids (from the port letters) */
+#define KEYPAD_ROW_PORT_ID               GPIO_PORT_ID(KEYPAD_ROW_PORT)
+#define KEYPAD_ROW_PORT_REG              GPIO_PORT_REG(KEYPAD_ROW_PORT)
+#define KEYPAD_ROW_DDR_REG               GPIO_DDR_REG(KEYPAD_ROW_PORT)
+#define KEYPAD_ROW_PIN_REG               GPIO_PIN_REG(KEYPAD_ROW_PORT)
+#define KEYPAD_COLUMN_PORT_ID            GPIO_PORT_ID(KEYPAD_COLUMN_PORT)
+
+/* keypad pins masks in the rows and columns ports */
+#define KEYPAD_ROWS_MASK                 ((uint8)((1<<KEYPAD_NUM_ROWS)-1))
+#define KEYPAD_ROWS_PINS_MASK            ((uint8)(KEYPAD_ROWS_MASK<<KEYPAD_FIRST_ROW_PIN_ID))
+#define KEYPAD_COLUMNS_PINS_MASK         ((uint8)(((1<<KEYPAD_NUM_COLS)-1)<<KEYPAD_FIRST_COLUMN_PIN_ID))
+#define KEYPAD_COLUMN_PIN_MASK(col)      ((uint8)(1<<(KEYPAD_FIRST_COLUMN_PIN_ID+(col))))
+
+/* precomputed column pins values to drive every column , the column is output and the rest are inputs */
+#if(KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+/* column output is low , other columns input with internal pull up */
+#define KEYPAD_COLUMN_PORT_VALUE(col)    ((uint8)(KEYPAD_COLUMNS_PINS_MASK & ~KEYPAD_COLUMN_PIN_MASK(col)))
+/* all columns output low */
+#define KEYPAD_STANDBY_PORT_VALUE        ((uint8)0)
+#else
+/* column output is high , other columns input without pull up */
+#define KEYPAD_COLUMN_PORT_VALUE(col)    KEYPAD_COLUMN_PIN_MASK(col)
+/* all columns output high */
+#define KEYPAD_STANDBY_PORT_VALUE        KEYPAD_COLUMNS_PINS_MASK
+#endif
+
+static const uint8 g_keypad_columnPort[KEYPAD_NUM_COLS] =
+{
+	KEYPAD_COLUMN_PORT_VALUE(0),KEYPAD_COLUMN_PORT_VALUE(1),KEYPAD_COLUMN_PORT_VALUE(2),
+#if (KEYPAD_NUM_COLS == 4)
+	KEYPAD_COLUMN_PORT_VALUE(3)
+#endif
+};
+static const uint8 g_keypad_columnDdr[KEYPAD_NUM_COLS] =
+{
+	KEYPAD_COLUMN_PIN_MASK(0),KEYPAD_COLUMN_PIN_MASK(1),KEYPAD_COLUMN_PIN_MASK(2),
+#if (KEYPAD_NUM_COLS == 4)
+	KEYPAD_COLUMN_PIN_MASK(3)
+#endif
+};
+
+/* keymap table in flash : key value of every bitmap bit , generated from KEYPAD_KEYMAP */
+#define KEYPAD_KEYMAP_COLUMN(row,col,key) [KEYPAD_BITMAP_INDEX(row,col)] = (key),
 #if (KEYPAD_NUM_COLS == 3)
+#define KEYPAD_KEYMAP_ENTRY(row,k0,k1,k2) \
+	KEYPAD_KEYMAP_COLUMN(row,0,k0) KEYPAD_KEYMAP_COLUMN(row,1,k1) KEYPAD_KEYMAP_COLUMN(row,2,k2)
+#elif (KEYPAD_NUM_COLS == 4)
+#define KEYPAD_KEYMAP_ENTRY(row,k0,k1,k2,k3) \
+	KEYPAD_KEYMAP_COLUMN(row,0,k0) KEYPAD_KEYMAP_COLUMN(row,1,k1) KEYPAD_KEYMAP_COLUMN(row,2,k2) \
+	KEYPAD_KEYMAP_COLUMN(row,3,k3)
+#endif
+
+static const uint8 g_keypad_keymap[KEYPAD_NUM_KEYS] PROGMEM =
+{
+	KEYPAD_KEYMAP(KEYPAD_KEYMAP_ENTRY)
+};
+
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+#if (KEYPAD_STANDBY_ENABLE == TRUE)
+ISR(INT0_vect)
+{
+	/* low level interrupt keeps firing while the key is held , disable it till next standby */
+	GICR &= ~(1<<INT0);
+	g_keypad_wakePending = TRUE;
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_WAKE_TO_KEY);
+}
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
+ * Function responsible for reading all the keypad buttons with the GPIO driver
+ * (same bitmap of KEYPAD_readBitmap)
  */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
-#elif (KEYPAD_NUM_COLS == 4)
+static KEYPAD_BitmapType KEYPAD_readButtonsGpio(void);
+
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
+ * Function responsible for scanning and debouncing the keypad (timebase hook every 1 ms)
  */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
-#endif
+static void KEYPAD_scan(void);
+
+/*
+ * Function responsible for adding a key event to the FIFO (event is dropped if the FIFO is full)
+ */
+static void KEYPAD_pushEvent(uint8 button,KEYPAD_EventType type);
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
+/*
+ * Description :
+ * Start the keypad scanner from the timebase (TIMEBASE_init must be called first)
+ */
+void KEYPAD_init(void)
+{
+	/* rows are inputs for ever (with internal pull up if a pressed key reads low) , columns are driven by the scanner */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		KEYPAD_ROW_DDR_REG &= (uint8)~KEYPAD_ROWS_PINS_MASK;
+#if(KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+		KEYPAD_ROW_PORT_REG |= KEYPAD_ROWS_PINS_MASK;
+#endif
+	}
+#if (KEYPAD_STANDBY_ENABLE == TRUE)
+	/* wake up pin is input , INT0 on low level (the only INT0 sense that wakes from power down) */
+	GPIO_PIN_INPUT(KEYPAD_WAKE_PIN);
+	GPIO_PIN_HIGH(KEYPAD_WAKE_PIN);
+	MCUCR &= ~((1<<ISC01)|(1<<ISC00));
+#endif
+	/* both scan paths are in the span records from the start , the scanner adds its own path */
+	KEYPAD_benchmarkScan();
+	if(!TIMEBASE_addHook(KEYPAD_scan))
+	{
+		TIMEBASE_halt(); /* no free timebase hook */
+	}
+}
+
+/*
+ * Description :
+ * Take the oldest key event from the FIFO
+ * Return TRUE if an event is taken or FALSE if the FIFO is empty
+ */
+boolean KEYPAD_getEvent(KEYPAD_Event * event_ptr)
+{
+	if(g_keypad_eventsTail == g_keypad_eventsHead)
+	{
+		return FALSE;
+	}
+	*event_ptr = g_keypad_events[g_keypad_eventsTail];
+	g_keypad_eventsTail = (g_keypad_eventsTail+1) & (KEYPAD_EVENTS_FIFO_SIZE-1);
+	return TRUE;
+}
+
+/*
+ * Description :
+ * Drop all key events waiting in the FIFO
+ */
+void KEYPAD_flushEvents(void)
+{
+	g_keypad_eventsTail = g_keypad_eventsHead;
+}
+
+/*
+ * Description :
+ * Wait for the next key press event and return its key
+ * (release and repeat events are dropped so a held key is read once)
+ */
 uint8 KEYPAD_getPressedKey(void)
 {
-	uint8 col,row;
-	uint8 keypad_port_value = 0;
-	while(1)
+	KEYPAD_Event event;
+	uint32 idle_start = TIMEBASE_now();
+	do
 	{
-		for(col=0;col<KEYPAD_NUM_COLS;col++) /* loop for columns */
+		while(!KEYPAD_getEvent(&event))
 		{
-			/*
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this column will be output pin
-			 */
-			GPIO_setupPortDirection(KEYPAD_PORT_ID,PORT_INPUT);
-			GPIO_setupPinDirection(KEYPAD_PORT_ID,KEYPAD_FIRST_COLUMN_PIN_ID+col,PIN_OUTPUT);
+#if (KEYPAD_STANDBY_ENABLE == TRUE)
+			if(TIMEBASE_hasElapsed(idle_start,KEYPAD_IDLE_TIMEOUT_MS))
+			{
+				KEYPAD_standby();
+				idle_start = TIMEBASE_now();
+			}
+#endif
+		}
+		idle_start = TIMEBASE_now();
+	} while(event.type != KEYPAD_EVENT_PRESS);
+	return event.key;
+}
 
+/*
+ * Description :
+ * Stop the scanner , drive all columns active and sleep till a key is pressed
+ * (the timebase is stopped while sleeping)
+ */
+void KEYPAD_standby(void)
+{
+	g_keypad_standby = TRUE;
+	GPIO_PORT_WRITE_MASKED(KEYPAD_COLUMN_PORT,KEYPAD_COLUMNS_PINS_MASK,KEYPAD_STANDBY_PORT_VALUE);
+	GPIO_DDR_WRITE_MASKED(KEYPAD_COLUMN_PORT,KEYPAD_COLUMNS_PINS_MASK,KEYPAD_COLUMNS_PINS_MASK);
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+
+	cli();
+	GIFR = (1<<INTF0); /* clear old request */
+	GICR |= (1<<INT0);
+	sleep_enable();
+	/* the instruction after sei is executed before any interrupt , so the wake up isn't missed */
+	sei();
+	sleep_cpu();
+	sleep_disable();
+
+	/* INT0 is disabled by its ISR , this covers a wake up by any other interrupt */
+	GICR &= ~(1<<INT0);
+	g_keypad_standby = FALSE;
+}
+
+/*
+ * Description :
+ * Read all the keypad keys with direct register access (one PIN read per column)
+ * Return the keys bitmap (see KEYPAD_BITMAP_BIT) and put the KEYPAD_SCAN_xxx flags in flags_ptr
+ */
+KEYPAD_BitmapType KEYPAD_readBitmap(uint8 * flags_ptr)
+{
+	uint8 col,other_col;
+	uint8 rows[KEYPAD_NUM_COLS];
+	uint8 common_rows;
+	KEYPAD_BitmapType bitmap = 0;
+
+	for(col=0;col<KEYPAD_NUM_COLS;col++)
+	{
+		/* only the column pins are changed , the rest of the port may be used by other drivers */
+		GPIO_DDR_WRITE_MASKED(KEYPAD_COLUMN_PORT,KEYPAD_COLUMNS_PINS_MASK,g_keypad_columnDdr[col]);
+		GPIO_PORT_WRITE_MASKED(KEYPAD_COLUMN_PORT,KEYPAD_COLUMNS_PINS_MASK,g_keypad_columnPort[col]);
+		_NOP(); /* let the PIN synchronizer catch the new column level */
 #if(KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
-			/* Clear the column output pin and set the rest pins value */
-			keypad_port_value = ~(1<<(KEYPAD_FIRST_COLUMN_PIN_ID+col));
+		rows[col] = (uint8)(~KEYPAD_ROW_PIN_REG >> KEYPAD_FIRST_ROW_PIN_ID) & KEYPAD_ROWS_MASK;
 #else
-			/* Set the column output pin and clear the rest pins value */
-			keypad_port_value = (1<<(KEYPAD_FIRST_COLUMN_PIN_ID+col));
+		rows[col] = (uint8)(KEYPAD_ROW_PIN_REG >> KEYPAD_FIRST_ROW_PIN_ID) & KEYPAD_ROWS_MASK;
 #endif
-			GPIO_writePort(KEYPAD_PORT_ID,keypad_port_value);
+	}
 
-			for(row=0;row<KEYPAD_NUM_ROWS;row++) /* loop for rows */
+	*flags_ptr = 0;
+	for(col=KEYPAD_NUM_COLS;col>0;col--)
+	{
+		bitmap = (bitmap<<KEYPAD_NUM_ROWS) | rows[col-1];
+	}
+	/* more than one bit set in the bitmap */
+	if(bitmap & (bitmap-1))
+	{
+		*flags_ptr |= KEYPAD_SCAN_MULTI_KEY;
+		for(col=0;col<KEYPAD_NUM_COLS;col++)
+		{
+			for(other_col=col+1;other_col<KEYPAD_NUM_COLS;other_col++)
 			{
-				/* Check if the switch is pressed in this row */
-				if(GPIO_readPin(KEYPAD_PORT_ID,row+KEYPAD_FIRST_ROW_PIN_ID) == KEYPAD_BUTTON_PRESSED)
+				common_rows = rows[col] & rows[other_col];
+				if(common_rows & (common_rows-1))
 				{
-					#if (KEYPAD_NUM_COLS == 3)
-						return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#elif (KEYPAD_NUM_COLS == 4)
-						return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#endif
+					*flags_ptr |= KEYPAD_SCAN_GHOSTING;
 				}
 			}
 		}
 	}
+	return bitmap;
 }
 
-#if (KEYPAD_NUM_COLS == 3)
-
 /*
  * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x3 shape
+ * Time one full keypad read with the fast path and one with the GPIO driver path
+ * into the spans TIMESTAMP_SPAN_KEYPAD_FAST_SCAN and TIMESTAMP_SPAN_KEYPAD_GPIO_SCAN
+ * (uses the timestamp driver , TIMESTAMP_init must be called first)
  */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
+void KEYPAD_benchmarkScan(void)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
+	uint8 flags;
+	/* no interrupt inside the spans , only the read itself is timed */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
 	{
-		case 10: keypad_button = '*'; // ASCII Code of *
-				 break;
-		case 11: keypad_button = 0;
-				 break;
-		case 12: keypad_button = '#'; // ASCII Code of #
-				 break;
-		default: keypad_button = button_number;
-				break;
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_KEYPAD_FAST_SCAN);
+		KEYPAD_readBitmap(&flags);
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_KEYPAD_FAST_SCAN);
+
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_KEYPAD_GPIO_SCAN);
+		KEYPAD_readButtonsGpio();
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_KEYPAD_GPIO_SCAN);
 	}
-	return keypad_button;
 }
 
-#elif (KEYPAD_NUM_COLS == 4)
-
 /*
  * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x4 shape
+ * Read all the keypad buttons using the GPIO driver
  */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
+static KEYPAD_BitmapType KEYPAD_readButtonsGpio(void)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
+	uint8 col,row,other_col;
+	KEYPAD_BitmapType buttons = 0;
+	for(col=0;col<KEYPAD_NUM_COLS;col++) /* loop for columns */
 	{
-		case 1: keypad_button = 7;
-				break;
-		case 2: keypad_button = 8;
-				break;
-		case 3: keypad_button = 9;
-				break;
-		case 4: keypad_button = '%'; // ASCII Code of %
-				break;
-		case 5: keypad_button = 4;
-				break;
-		case 6: keypad_button = 5;
-				break;
-		case 7: keypad_button = 6;
-				break;
-		case 8: keypad_button = '*'; /* ASCII Code of '*' */
-				break;
-		case 9: keypad_button = 1;
-				break;
-		case 10: keypad_button = 2;
-				break;
-		case 11: keypad_button = 3;
-				break;
-		case 12: keypad_button = '-'; /* ASCII Code of '-' */
-				break;
-		case 13: keypad_button = 13;  /* ASCII of Enter */
-				break;
-		case 14: keypad_button = 0;
-				break;
-		case 15: keypad_button = '='; /* ASCII Code of '=' */
-				break;
-		case 16: keypad_button = '+'; /* ASCII Code of '+' */
-				break;
-		default: keypad_button = button_number;
-				break;
+		/*
+		 * Each time setup the direction for all keypad column pins as input pins,
+		 * except this column will be output pin
+		 */
+		for(other_col=0;other_col<KEYPAD_NUM_COLS;other_col++)
+		{
+			GPIO_setupPinDirection(KEYPAD_COLUMN_PORT_ID,KEYPAD_FIRST_COLUMN_PIN_ID+other_col,PIN_INPUT);
+#if(KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+			GPIO_writePin(KEYPAD_COLUMN_PORT_ID,KEYPAD_FIRST_COLUMN_PIN_ID+other_col,LOGIC_HIGH);
+#else
+			GPIO_writePin(KEYPAD_COLUMN_PORT_ID,KEYPAD_FIRST_COLUMN_PIN_ID+other_col,LOGIC_LOW);
+#endif
+		}
+		GPIO_setupPinDirection(KEYPAD_COLUMN_PORT_ID,KEYPAD_FIRST_COLUMN_PIN_ID+col,PIN_OUTPUT);
+		GPIO_writePin(KEYPAD_COLUMN_PORT_ID,KEYPAD_FIRST_COLUMN_PIN_ID+col,KEYPAD_BUTTON_PRESSED);
+
+		for(row=0;row<KEYPAD_NUM_ROWS;row++) /* loop for rows */
+		{
+			/* Check if the switch is pressed in this row */
+			if(GPIO_readPin(KEYPAD_ROW_PORT_ID,row+KEYPAD_FIRST_ROW_PIN_ID) == KEYPAD_BUTTON_PRESSED)
+			{
+				buttons |= KEYPAD_BITMAP_BIT(row,col);
+			}
+		}
 	}
-	return keypad_button;
+	return buttons;
 }
 
+/*
+ * Description :
+ * Scan the keypad every KEYPAD_SCAN_PERIOD_MS and debounce every key,
+ * key changes and repeats are added to the events FIFO
+ */
+static void KEYPAD_scan(void)
+{
+	static uint8 s_scanTicks = 0;
+	uint8 button;
+	KEYPAD_BitmapType button_mask;
+	KEYPAD_BitmapType buttons;
+	uint8 scan_flags = 0;
+
+	s_scanTicks++;
+	if((s_scanTicks < KEYPAD_SCAN_PERIOD_MS) || g_keypad_standby)
+	{
+		return;
+	}
+	s_scanTicks = 0;
+
+#if (KEYPAD_FAST_SCAN == TRUE)
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_KEYPAD_FAST_SCAN);
+	buttons = KEYPAD_readBitmap(&scan_flags);
+	TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_KEYPAD_FAST_SCAN);
+#else
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_KEYPAD_GPIO_SCAN);
+	buttons = KEYPAD_readButtonsGpio();
+	TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_KEYPAD_GPIO_SCAN);
 #endif
+	/* phantom keys can't be told from real ones , keep the last debounced state */
+	if(scan_flags & KEYPAD_SCAN_GHOSTING)
+	{
+		return;
+	}
+	for(button=0,button_mask=1;button<KEYPAD_NUM_KEYS;button++,button_mask<<=1)
+	{
+		if(buttons & button_mask)
+		{
+			if(g_keypad_debounce[button] < KEYPAD_DEBOUNCE_SCANS)
+			{
+				g_keypad_debounce[button]++;
+			}
+			/* stable pressed : report the press once */
+			if((g_keypad_debounce[button] == KEYPAD_DEBOUNCE_SCANS) && !(g_keypad_state & button_mask))
+			{
+				g_keypad_state |= button_mask;
+				KEYPAD_pushEvent(button,KEYPAD_EVENT_PRESS);
+				g_keypad_repeatButton = button;
+				g_keypad_repeatScans = KEYPAD_REPEAT_DELAY_MS/KEYPAD_SCAN_PERIOD_MS;
+			}
+		}
+		else
+		{
+			if(g_keypad_debounce[button] > 0)
+			{
+				g_keypad_debounce[button]--;
+			}
+			/* stable released : report the release once */
+			if((g_keypad_debounce[button] == 0) && (g_keypad_state & button_mask))
+			{
+				g_keypad_state &= ~button_mask;
+				KEYPAD_pushEvent(button,KEYPAD_EVENT_RELEASE);
+			}
+		}
+	}
+
+	/* repeat the last pressed key while it is held */
+	if(g_keypad_state & ((KEYPAD_BitmapType)1<<g_keypad_repeatButton))
+	{
+		g_keypad_repeatScans--;
+		if(g_keypad_repeatScans == 0)
+		{
+			KEYPAD_pushEvent(g_keypad_repeatButton,KEYPAD_EVENT_REPEAT);
+			g_keypad_repeatScans = KEYPAD_REPEAT_PERIOD_MS/KEYPAD_SCAN_PERIOD_MS;
+		}
+	}
+}
+
+/*
+ * Description :
+ * Add a key event to the FIFO with the key value of the button (from the flash keymap)
+ */
+static void KEYPAD_pushEvent(uint8 button,KEYPAD_EventType type)
+{
+	uint8 next_head = (g_keypad_eventsHead+1) & (KEYPAD_EVENTS_FIFO_SIZE-1);
+	if(next_head == g_keypad_eventsTail)
+	{
+		return; /* FIFO is full */
+	}
+	g_keypad_events[g_keypad_eventsHead].key = pgm_read_byte(&g_keypad_keymap[button]);
+	g_keypad_events[g_keypad_eventsHead].type = type;
+	g_keypad_eventsHead = next_head;
+
+	if(g_keypad_wakePending)
+	{
+		g_keypad_wakePending = FALSE;
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_WAKE_TO_KEY);
+	}
+}
@@ -19,27 +19,161 @@
  *                                Definitions                                  *
  *******************************************************************************/
 
-/* Keypad configurations for number of rows and columns */
+/* Keypad configurations for number of rows and columns (4x3 , 4x4 or 5x4) */
 #define KEYPAD_NUM_COLS                  4
 #define KEYPAD_NUM_ROWS                  4
 
-/* Keypad Port Configurations */
-#define KEYPAD_PORT_ID                   PORTB_ID
+/* Keypad Port Configurations as port letters A..D (rows and columns may be on different ports ,
+ * a 5x4 keypad needs 9 pins e.g. rows PB0..PB4 and columns PA4..PA7)
+ */
+#define KEYPAD_ROW_PORT                  B
+#define KEYPAD_COLUMN_PORT               B
 
 #define KEYPAD_FIRST_ROW_PIN_ID           PIN0_ID
 #define KEYPAD_FIRST_COLUMN_PIN_ID        PIN4_ID
 
+/* TRUE : scanner reads all rows of a column in one PIN register read
+ * FALSE: scanner uses the GPIO driver for every pin */
+#define KEYPAD_FAST_SCAN                 TRUE
+
+/* Keypad key values : digit keys are 0..9 , the other keys are their ASCII code
+ * (Backspace is ASCII Delete , ASCII Backspace 8 would be read as the digit 8)
+ */
+#define KEYPAD_KEY_ENTER                 13   /* Enter (ON/C) */
+#define KEYPAD_KEY_ESCAPE                27
+#define KEYPAD_KEY_BACKSPACE             0x7F
+#define KEYPAD_IS_DIGIT(key)             ((key)<=9)
+
+/* Keypad keymaps : key value of every button row by row as printed on the keypad ,
+ * KEYPAD_ROW(row,keys of columns 0..n) , turned into a flash table indexed by the scan bitmap bit
+ */
+#define KEYPAD_KEYMAP_4x3(KEYPAD_ROW) \
+	KEYPAD_ROW(0,  1 ,  2 ,  3 ) \
+	KEYPAD_ROW(1,  4 ,  5 ,  6 ) \
+	KEYPAD_ROW(2,  7 ,  8 ,  9 ) \
+	KEYPAD_ROW(3, '*',  0 , '#')
+
+#define KEYPAD_KEYMAP_4x4(KEYPAD_ROW) \
+	KEYPAD_ROW(0,  7 ,  8 ,  9 , '%') \
+	KEYPAD_ROW(1,  4 ,  5 ,  6 , '*') \
+	KEYPAD_ROW(2,  1 ,  2 ,  3 , '-') \
+	KEYPAD_ROW(3, KEYPAD_KEY_ENTER,  0 , '=', '+')
+
+#define KEYPAD_KEYMAP_5x4(KEYPAD_ROW) \
+	KEYPAD_ROW(0, '+', '-', '%', '*') \
+	KEYPAD_ROW(1,  7 ,  8 ,  9 , '=') \
+	KEYPAD_ROW(2,  4 ,  5 ,  6 , '#') \
+	KEYPAD_ROW(3,  1 ,  2 ,  3 , KEYPAD_KEY_BACKSPACE) \
+	KEYPAD_ROW(4, KEYPAD_KEY_ESCAPE,  0 , '.', KEYPAD_KEY_ENTER)
+
+#if ((KEYPAD_NUM_ROWS == 4) && (KEYPAD_NUM_COLS == 3))
+#define KEYPAD_KEYMAP                    KEYPAD_KEYMAP_4x3
+#elif ((KEYPAD_NUM_ROWS == 4) && (KEYPAD_NUM_COLS == 4))
+#define KEYPAD_KEYMAP                    KEYPAD_KEYMAP_4x4
+#elif ((KEYPAD_NUM_ROWS == 5) && (KEYPAD_NUM_COLS == 4))
+#define KEYPAD_KEYMAP                    KEYPAD_KEYMAP_5x4
+#else
+#error "Keypad layout has no keymap"
+#endif
+
 /* Keypad button logic configurations */
 #define KEYPAD_BUTTON_PRESSED        LOGIC_LOW
 #define KEYPAD_BUTTON_RELEASED       LOGIC_HIGH
 
+/* Keypad scanner configurations (scanner runs from the timebase every 1 ms) */
+#define KEYPAD_NUM_KEYS                  (KEYPAD_NUM_ROWS*KEYPAD_NUM_COLS)
+#define KEYPAD_SCAN_PERIOD_MS            5   /* scan the matrix every 5 ms */
+#define KEYPAD_DEBOUNCE_SCANS            4   /* key must be stable for 4 scans (20 ms) */
+#define KEYPAD_REPEAT_DELAY_MS           500 /* held key starts repeating after 500 ms */
+#define KEYPAD_REPEAT_PERIOD_MS          150 /* then repeats every 150 ms */
+#define KEYPAD_EVENTS_FIFO_SIZE          8   /* must be power of 2 */
+
+/* Keypad standby configurations :
+ * after KEYPAD_IDLE_TIMEOUT_MS without key events KEYPAD_getPressedKey drives all columns active
+ * and sleeps (power down) , the rows are AND-ed in hardware on the INT0 pin so any key wakes the MCU
+ */
+#define KEYPAD_STANDBY_ENABLE            TRUE
+#define KEYPAD_IDLE_TIMEOUT_MS           10000
+#define KEYPAD_WAKE_PIN                  GPIO_PIN(D,PIN2_ID)  /* INT0 */
+
+/* Keypad bitmap : bit (col*KEYPAD_NUM_ROWS+row) is set if the key is pressed */
+#define KEYPAD_BITMAP_INDEX(row,col)     (((col)*KEYPAD_NUM_ROWS)+(row))
+#define KEYPAD_BITMAP_BIT(row,col)       ((KEYPAD_BitmapType)1<<KEYPAD_BITMAP_INDEX(row,col))
+
+/* flags returned by KEYPAD_readBitmap */
+#define KEYPAD_SCAN_MULTI_KEY            (1<<0) /* more than one key is pressed */
+#define KEYPAD_SCAN_GHOSTING             (1<<1) /* two columns share two rows : a phantom key may be read */
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+#if (KEYPAD_NUM_KEYS > 16)
+typedef uint32 KEYPAD_BitmapType;
+#else
+typedef uint16 KEYPAD_BitmapType;
+#endif
+
+typedef enum
+{
+	KEYPAD_EVENT_PRESS,KEYPAD_EVENT_RELEASE,KEYPAD_EVENT_REPEAT
+}KEYPAD_EventType;
+
+typedef struct
+{
+	uint8 key;              /* key value (same as KEYPAD_getPressedKey) */
+	KEYPAD_EventType type;
+}KEYPAD_Event;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
 /*
  * Description :
- * Get the Keypad pressed button
+ * Start the keypad scanner from the timebase (TIMEBASE_init must be called first)
+ */
+void KEYPAD_init(void);
+
+/*
+ * Description :
+ * Take the oldest key event from the FIFO
+ * Return TRUE if an event is taken or FALSE if the FIFO is empty
+ */
+boolean KEYPAD_getEvent(KEYPAD_Event * event_ptr);
+
+/*
+ * Description :
+ * Drop all key events waiting in the FIFO
+ */
+void KEYPAD_flushEvents(void);
+
+/*
+ * Description :
+ * Read all the keypad keys with direct register access (one PIN read per column)
+ * Return the keys bitmap (see KEYPAD_BITMAP_BIT) and put the KEYPAD_SCAN_xxx flags in flags_ptr
+ */
+KEYPAD_BitmapType KEYPAD_readBitmap(uint8 * flags_ptr);
+
+/*
+ * Description :
+ * Time one full keypad read with the fast path and one with the GPIO driver path
+ * into the spans TIMESTAMP_SPAN_KEYPAD_FAST_SCAN and TIMESTAMP_SPAN_KEYPAD_GPIO_SCAN
+ * (uses the timestamp driver , TIMESTAMP_init must be called first)
+ */
+void KEYPAD_benchmarkScan(void);
+
+/*
+ * Description :
+ * Stop the scanner , drive all columns active and sleep till a key is pressed
+ * (the timebase is stopped while sleeping)
+ */
+void KEYPAD_standby(void);
+
+/*
+ * Description :
+ * Wait for the next key press event and return its key
+ * (release and repeat events are dropped so a held key is read once)
+ * the keypad goes to standby if no key events come for KEYPAD_IDLE_TIMEOUT_MS
  */
 uint8 KEYPAD_getPressedKey(void);
 
@@ -11,9 +11,100 @@
  *******************************************************************************/
 
 #include <util/delay.h> /* For the delay functions */
+#include <stdlib.h> /* For itoa */
+#include <avr/pgmspace.h> /* To read the flash strings */
 #include "common_macros.h" /* To use the macros like SET_BIT */
-
+#include "lcd.h"
 #include "gpio.h"
+#include "timebase.h"
+#include "timestamp.h"
+#include <avr/io.h> /* To use the LCD data port registers */
+#include <util/atomic.h>
+
+/* data port registers (the data pins are changed with read-modify-write) */
+#define LCD_DATA_PORT_REG              GPIO_PORT_REG(LCD_DATA_PORT)
+#define LCD_DATA_DDR_REG               GPIO_DDR_REG(LCD_DATA_PORT)
+#define LCD_DATA_PIN_REG               GPIO_PIN_REG(LCD_DATA_PORT)
+
+/* CPU cycles of LCD_QUEUE_TIME_PER_TICK_US */
+#define LCD_QUEUE_TIME_CYCLES          ((uint32)LCD_QUEUE_TIME_PER_TICK_US*(F_CPU/1000000UL))
+
+/* RS and RW pins are written together in the control port */
+#define LCD_CONTROL_PORT               GPIO_PIN_PORT(LCD_RS_PIN)
+#define LCD_RS_RW_MASK                 (GPIO_PIN_MASK(LCD_RS_PIN) | GPIO_PIN_MASK(LCD_RW_PIN))
+
+/* LCD data pins in the data port and the busy flag (D7) pin */
+#if (LCD_DATA_BITS_MODE == 4)
+#define LCD_DATA_PINS_MASK             ((uint8)(0x0F<<LCD_FIRST_DATA_PIN_ID))
+#define LCD_BUSY_FLAG_MASK             ((uint8)(1<<(LCD_FIRST_DATA_PIN_ID+3)))
+#elif (LCD_DATA_BITS_MODE == 8)
+#define LCD_DATA_PINS_MASK             ((uint8)0xFF)
+#define LCD_BUSY_FLAG_MASK             ((uint8)(1<<PIN7_ID))
+#else
+#error "LCD data bits mode must be 4 or 8"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* cleared if the busy flag timed out once (LCD not answering reads) , then the fixed delays are used */
+static volatile boolean g_lcd_busyFlagWorking = LCD_BUSY_FLAG_ENABLE;
+
+#if (LCD_ASYNC_ENABLE == TRUE)
+/* queued writes (RS value and byte) , written by the application and read by the timebase interrupt */
+typedef struct
+{
+	uint8 rs;
+	uint8 value;
+}s_lcd_QueueEntry;
+
+/* volatile : the entry is stored before the head that publishes it to the interrupt */
+static volatile s_lcd_QueueEntry g_lcd_queue[LCD_QUEUE_SIZE];
+static volatile uint8 g_lcd_queueHead = 0;
+static volatile uint8 g_lcd_queueTail = 0;
+/* ticks the busy flag is still set for the last write , and ticks left of a fixed delay */
+static uint8 g_lcd_busyTicks = 0;
+static uint8 g_lcd_delayTicks = 0;
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for reading the LCD busy flag once
+ */
+static uint8 LCD_readBusyFlag(void);
+
+#if (LCD_ASYNC_ENABLE == FALSE)
+/*
+ * Function responsible for waiting till the LCD can take the next instruction or data
+ */
+static void LCD_waitReady(void);
+#endif
+
+/*
+ * Function responsible for putting the data pins value (already shifted to the data pins) on the bus with one enable pulse
+ */
+static void LCD_writeBus(uint8 pins_value);
+
+/*
+ * Function responsible for writing one instruction (RS=0) or data (RS=1) byte to the LCD
+ */
+static void LCD_write(uint8 rs,uint8 value);
+
+/*
+ * Function responsible for passing one instruction or data byte to the LCD (queued or written)
+ */
+static void LCD_send(uint8 rs,uint8 value);
+
+#if (LCD_ASYNC_ENABLE == TRUE)
+/*
+ * Function responsible for writing the queued bytes while the LCD is ready (timebase hook every 1 ms)
+ */
+static void LCD_writeQueue(void);
+#endif
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -28,35 +119,71 @@
 void LCD_init(void)
 {
 	/* Configure the direction for RS, RW and E pins as output pins */
-	GPIO_setupPinDirection(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_RW_PORT_ID,LCD_RW_PIN_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
+	GPIO_PIN_OUTPUT(LCD_RS_PIN);
+	GPIO_PIN_OUTPUT(LCD_RW_PIN);
+	GPIO_PIN_OUTPUT(LCD_E_PIN);
 
-	/* Configure the data port as output port */
-	GPIO_setupPortDirection(LCD_DATA_PORT_ID,PORT_OUTPUT);
+	/* Configure the data pins as output pins */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		LCD_DATA_DDR_REG |= LCD_DATA_PINS_MASK;
+	}
+
+	/* the busy flag can't be read till the LCD internal reset is done */
+	_delay_ms(LCD_POWER_ON_DELAY_MS);
+
+#if (LCD_DATA_BITS_MODE == 4)
+	/*
+	 * Initialization by instruction with fixed delays (the busy flag can't be read yet):
+	 * three 8-bit function sets to reach a known state from any mode , then switch to 4-bit
+	 */
+	GPIO_PORT_WRITE_MASKED(LCD_CONTROL_PORT,LCD_RS_RW_MASK,0); /* Instruction Mode RS=0 , write data to LCD so RW=0 */
+	LCD_writeBus(0x03<<LCD_FIRST_DATA_PIN_ID);
+	_delay_ms(5); /* more than 4.1 ms */
+	LCD_writeBus(0x03<<LCD_FIRST_DATA_PIN_ID);
+	_delay_us(2*LCD_COMMAND_DELAY_US); /* more than 100 us */
+	LCD_writeBus(0x03<<LCD_FIRST_DATA_PIN_ID);
+	_delay_us(2*LCD_COMMAND_DELAY_US);
+	LCD_writeBus(0x02<<LCD_FIRST_DATA_PIN_ID);
+	_delay_us(2*LCD_COMMAND_DELAY_US);
+#endif
 
+#if (LCD_ASYNC_ENABLE == TRUE)
+	if(!TIMEBASE_addHook(LCD_writeQueue))
+	{
+		TIMEBASE_halt(); /* no free timebase hook */
+	}
+#endif
+
+#if (LCD_DATA_BITS_MODE == 4)
+	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE); /* use 2-line lcd + 4-bit Data Mode + 5*7 dot display Mode */
+#else
 	LCD_sendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE); /* use 2-line lcd + 8-bit Data Mode + 5*7 dot display Mode */
+#endif
 
 	LCD_sendCommand(LCD_CURSOR_OFF); /* cursor off */
 
 	LCD_sendCommand(LCD_CLEAR_COMMAND); /* clear LCD at the beginning */
 }
 
+/*
+ * Description :
+ * Wait till all the queued commands and data are written to the LCD
+ */
+void LCD_flush(void)
+{
+#if (LCD_ASYNC_ENABLE == TRUE)
+	while(g_lcd_queueTail != g_lcd_queueHead){}
+#endif
+}
+
 /*
  * Description :
  * Send the required command to the screen
  */
 void LCD_sendCommand(uint8 command)
 {
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
-	GPIO_writePin(LCD_RW_PORT_ID,LCD_RW_PIN_ID,LOGIC_LOW); /* write data to LCD so RW=0 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-	GPIO_writePort(LCD_DATA_PORT_ID,command); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	LCD_send(LOGIC_LOW,command); /* Instruction Mode RS=0 */
 }
 
 /*
@@ -65,15 +192,7 @@ void LCD_sendCommand(uint8 command)
  */
 void LCD_displayCharacter(uint8 data)
 {
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
-	GPIO_writePin(LCD_RW_PORT_ID,LCD_RW_PIN_ID,LOGIC_LOW); /* write data to LCD so RW=0 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-	GPIO_writePort(LCD_DATA_PORT_ID,data); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
+	LCD_send(LOGIC_HIGH,data); /* Data Mode RS=1 */
 }
 
 /*
@@ -97,6 +216,20 @@ void LCD_displayString(const char *Str)
 	*********************************************************/
 }
 
+/*
+ * Description :
+ * Display the required string stored in flash (PROGMEM) on the screen
+ */
+void LCD_displayString_P(const char *Str)
+{
+	uint8 data;
+	while((data = pgm_read_byte(Str)) != '\0')
+	{
+		LCD_displayCharacter(data);
+		Str++;
+	}
+}
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
@@ -109,16 +242,16 @@ void LCD_moveCursor(uint8 row,uint8 col)
 	switch(row)
 	{
 		case 0:
-			lcd_memory_address=col;
+			lcd_memory_address=col+LCD_ROW0_ADDRESS;
 				break;
 		case 1:
-			lcd_memory_address=col+0x40;
+			lcd_memory_address=col+LCD_ROW1_ADDRESS;
 				break;
 		case 2:
-			lcd_memory_address=col+0x10;
+			lcd_memory_address=col+LCD_ROW2_ADDRESS;
 				break;
 		case 3:
-			lcd_memory_address=col+0x50;
+			lcd_memory_address=col+LCD_ROW3_ADDRESS;
 				break;
 	}
 	/* Move the LCD cursor to this specific address */
@@ -135,6 +268,30 @@ void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
 	LCD_displayString(Str); /* display the string */
 }
 
+/*
+ * Description :
+ * Display the required string stored in flash (PROGMEM) in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str)
+{
+	LCD_moveCursor(row,col); /* go to to the required LCD position */
+	LCD_displayString_P(Str); /* display the string */
+}
+
+/*
+ * Description :
+ * Upload a custom character pattern to CGRAM (the address counter is left in CGRAM)
+ */
+void LCD_createCharacter(uint8 code,const uint8 *pattern)
+{
+	uint8 row;
+	LCD_sendCommand(LCD_SET_CGRAM_ADDRESS | ((code & (LCD_CUSTOM_CHARACTERS-1))*LCD_CHARACTER_ROWS));
+	for(row=0;row<LCD_CHARACTER_ROWS;row++)
+	{
+		LCD_displayCharacter(pattern[row]);
+	}
+}
+
 /*
  * Description :
  * Display the required decimal value on the screen
@@ -154,3 +311,179 @@ void LCD_clearScreen(void)
 {
 	LCD_sendCommand(LCD_CLEAR_COMMAND); /* Send clear display command */
 }
+
+/*
+ * Description :
+ * Read the busy flag (D7 with RS=0 and RW=1) , the data pins are left as outputs
+ * (in 4-bit mode the flag is in the high nibble and the low nibble is read and dropped)
+ */
+static uint8 LCD_readBusyFlag(void)
+{
+	uint8 busy;
+	/* data pins input without pull ups , an open bus reads as not busy */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		LCD_DATA_DDR_REG &= (uint8)~LCD_DATA_PINS_MASK;
+		LCD_DATA_PORT_REG &= (uint8)~LCD_DATA_PINS_MASK; /* both registers in one atomic block */
+	}
+	/* Instruction Mode RS=0 , read busy flag from LCD so RW=1 */
+	GPIO_PORT_WRITE_MASKED(LCD_CONTROL_PORT,LCD_RS_RW_MASK,GPIO_PIN_MASK(LCD_RW_PIN));
+	GPIO_PIN_HIGH(LCD_E_PIN); /* Enable LCD E=1 */
+	_delay_us(1); /* delay for processing Tddr = 160ns */
+	busy = ((LCD_DATA_PIN_REG & LCD_BUSY_FLAG_MASK) != 0);
+	GPIO_PIN_LOW(LCD_E_PIN); /* Disable LCD E=0 */
+#if (LCD_DATA_BITS_MODE == 4)
+	_delay_us(1); /* delay for processing Tcycle = 500ns */
+	GPIO_PIN_HIGH(LCD_E_PIN); /* low nibble of the address counter */
+	_delay_us(1);
+	GPIO_PIN_LOW(LCD_E_PIN);
+#endif
+	GPIO_PIN_LOW(LCD_RW_PIN);
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		LCD_DATA_DDR_REG |= LCD_DATA_PINS_MASK;
+	}
+	return busy;
+}
+
+#if (LCD_ASYNC_ENABLE == FALSE)
+/*
+ * Description :
+ * Poll the busy flag till the LCD is ready or the poll times out
+ */
+static void LCD_waitReady(void)
+{
+	uint16 reads = 0;
+	uint8 busy;
+
+	if(!g_lcd_busyFlagWorking)
+	{
+		return;
+	}
+	do
+	{
+		busy = LCD_readBusyFlag();
+		_delay_us(1); /* delay for processing Tcycle = 500ns */
+		reads++;
+	} while(busy && (reads < LCD_BUSY_TIMEOUT_READS));
+
+	if(busy)
+	{
+		/* LCD never got ready , use the fixed delays from now on */
+		g_lcd_busyFlagWorking = FALSE;
+		_delay_us(LCD_SLOW_COMMAND_DELAY_US);
+	}
+}
+#endif
+
+/*
+ * Description :
+ * Put the value on the data pins (one read-modify-write of the data port) with one enable pulse
+ */
+static void LCD_writeBus(uint8 pins_value)
+{
+	GPIO_PIN_HIGH(LCD_E_PIN); /* Enable LCD E=1 (Tas = 50ns passed) */
+	GPIO_PORT_WRITE_MASKED(LCD_DATA_PORT,LCD_DATA_PINS_MASK,pins_value);
+	_delay_us(1); /* delay for processing Tpw = 230ns and Tdsw = 100ns */
+	GPIO_PIN_LOW(LCD_E_PIN); /* Disable LCD E=0 */
+	_delay_us(1); /* delay for processing Th = 13ns and Tcycle = 500ns */
+}
+
+/*
+ * Description :
+ * Write the byte (two nibbles , high first , in 4-bit mode) , the LCD must be ready
+ */
+static void LCD_write(uint8 rs,uint8 value)
+{
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_LCD_WRITE);
+	/* RS as required , write data to LCD so RW=0 */
+	GPIO_PORT_WRITE_MASKED(LCD_CONTROL_PORT,LCD_RS_RW_MASK,(rs ? GPIO_PIN_MASK(LCD_RS_PIN) : 0));
+#if (LCD_DATA_BITS_MODE == 4)
+	LCD_writeBus((value>>4)<<LCD_FIRST_DATA_PIN_ID); /* D7 --> D4 of the high nibble */
+	LCD_writeBus((value&0x0F)<<LCD_FIRST_DATA_PIN_ID); /* D7 --> D4 of the low nibble */
+#else
+	LCD_writeBus(value); /* out the required byte to the data bus D0 --> D7 */
+#endif
+	TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_LCD_WRITE);
+}
+
+/*
+ * Description :
+ * Queue the byte (async mode) or wait for the LCD and write it
+ */
+static void LCD_send(uint8 rs,uint8 value)
+{
+#if (LCD_ASYNC_ENABLE == TRUE)
+	uint8 next_head = (g_lcd_queueHead+1) & (LCD_QUEUE_SIZE-1);
+	while(next_head == g_lcd_queueTail){} /* queue is full , wait for the interrupt to write one */
+	g_lcd_queue[g_lcd_queueHead].rs = rs;
+	g_lcd_queue[g_lcd_queueHead].value = value;
+	g_lcd_queueHead = next_head;
+#else
+	LCD_waitReady();
+	LCD_write(rs,value);
+	if(g_lcd_busyFlagWorking)
+	{
+		return;
+	}
+	/* no busy flag , wait the command execution time */
+	if((rs == LOGIC_LOW) && ((value == LCD_CLEAR_COMMAND) || (value == LCD_GO_TO_HOME)))
+	{
+		_delay_us(LCD_SLOW_COMMAND_DELAY_US);
+	}
+	else
+	{
+		_delay_us(LCD_COMMAND_DELAY_US);
+	}
+#endif
+}
+
+#if (LCD_ASYNC_ENABLE == TRUE)
+/*
+ * Description :
+ * Write the queued bytes when the busy flag is clear for LCD_QUEUE_TIME_PER_TICK_US per tick,
+ * without the busy flag write one byte per tick and skip ticks after the slow commands
+ */
+static void LCD_writeQueue(void)
+{
+	uint32 start = TIMESTAMP_now();
+	boolean written = FALSE;
+	volatile s_lcd_QueueEntry * entry_ptr;
+
+	if(g_lcd_delayTicks > 0)
+	{
+		g_lcd_delayTicks--;
+		return;
+	}
+	while((g_lcd_queueTail != g_lcd_queueHead) && ((TIMESTAMP_now()-start) < LCD_QUEUE_TIME_CYCLES))
+	{
+		if(g_lcd_busyFlagWorking && LCD_readBusyFlag())
+		{
+			continue;
+		}
+		written = TRUE;
+		g_lcd_busyTicks = 0;
+		entry_ptr = &g_lcd_queue[g_lcd_queueTail];
+		LCD_write(entry_ptr->rs,entry_ptr->value);
+		g_lcd_queueTail = (g_lcd_queueTail+1) & (LCD_QUEUE_SIZE-1);
+		if(!g_lcd_busyFlagWorking)
+		{
+			if((entry_ptr->rs == LOGIC_LOW) && ((entry_ptr->value == LCD_CLEAR_COMMAND) || (entry_ptr->value == LCD_GO_TO_HOME)))
+			{
+				g_lcd_delayTicks = (LCD_SLOW_COMMAND_DELAY_US/1000);
+			}
+			return;
+		}
+	}
+	/* still busy for the whole time of this tick */
+	if((!written) && (g_lcd_queueTail != g_lcd_queueHead))
+	{
+		g_lcd_busyTicks++;
+		if(g_lcd_busyTicks >= LCD_BUSY_TIMEOUT_TICKS)
+		{
+			/* LCD never got ready , use the fixed delays from now on */
+			g_lcd_busyFlagWorking = FALSE;
+		}
+	}
+}
+#endif
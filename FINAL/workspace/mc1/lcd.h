@@ -18,17 +18,52 @@
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
-/* LCD HW Ports and Pins Ids */
-#define LCD_RS_PORT_ID                 PORTA_ID
-#define LCD_RS_PIN_ID                  PIN0_ID
+/* LCD HW control Pins (compile time pins , see GPIO_PIN) , RS and RW must be on the same port */
+#define LCD_RS_PIN                     GPIO_PIN(A,PIN0_ID)
+#define LCD_RW_PIN                     GPIO_PIN(A,PIN1_ID)
+#define LCD_E_PIN                      GPIO_PIN(A,PIN2_ID)
+
+/* LCD columns (16 or 20) , rows 2 and 3 of a 4 line LCD continue the DDRAM lines of rows 0 and 1 after them */
+#define LCD_COLS                       16
+#define LCD_ROW0_ADDRESS               0x00
+#define LCD_ROW1_ADDRESS               0x40
+#define LCD_ROW2_ADDRESS               (LCD_ROW0_ADDRESS+LCD_COLS)
+#define LCD_ROW3_ADDRESS               (LCD_ROW1_ADDRESS+LCD_COLS)
+
+/* LCD data bus mode : 8 (D0..D7 on the whole data port) or 4 (D4..D7 on 4 pins , the other 4 pins are free) */
+#define LCD_DATA_BITS_MODE             8
+
+/* LCD data port letter (A..D) */
+#define LCD_DATA_PORT                  C
+/* pin of D4 in 4-bit mode (D4..D7 on this pin and the next 3 pins) */
+#define LCD_FIRST_DATA_PIN_ID          PIN4_ID
+
+/* TRUE : wait for the LCD busy flag (D7 read with RW=1) before every write
+ * FALSE: wait a fixed delay after every write */
+#define LCD_BUSY_FLAG_ENABLE           TRUE
+
+/* busy flag reads before giving up (about 2 ms) , after a timeout the driver uses the fixed delays */
+#define LCD_BUSY_TIMEOUT_READS         500
+
+/* TRUE : commands and data are queued and written by the timebase interrupt at the LCD pace
+ * FALSE: every command and data write waits for the LCD */
+#define LCD_ASYNC_ENABLE               TRUE
+
+/* queued LCD writes (power of 2) , a full queue makes the writer wait ,
+ * it holds a full screen render : (LCD_COLS+1) writes per row , 34 for 2x16 (use 128 for 4x20)
+ */
+#define LCD_QUEUE_SIZE                 64
 
-#define LCD_RW_PORT_ID                 PORTA_ID
-#define LCD_RW_PIN_ID                  PIN1_ID
+/* LCD time per timebase tick in us (writes and busy flag reads , bounds the LCD time in the interrupt) */
+#define LCD_QUEUE_TIME_PER_TICK_US     250
 
-#define LCD_E_PORT_ID                  PORTA_ID
-#define LCD_E_PIN_ID                   PIN2_ID
+/* ticks (ms) the busy flag may stay set in async mode before the driver uses the fixed delays */
+#define LCD_BUSY_TIMEOUT_TICKS         5
 
-#define LCD_DATA_PORT_ID               PORTC_ID
+/* fixed delays of the worst case execution times (clear and home 1.52 ms , others 37 us) */
+#define LCD_POWER_ON_DELAY_MS          20
+#define LCD_SLOW_COMMAND_DELAY_US      2000
+#define LCD_COMMAND_DELAY_US           50
 
 /* LCD Commands */
 #define LCD_CLEAR_COMMAND              0x01
@@ -38,6 +73,11 @@
 #define LCD_CURSOR_OFF                 0x0C
 #define LCD_CURSOR_ON                  0x0E
 #define LCD_SET_CURSOR_LOCATION        0x80
+#define LCD_SET_CGRAM_ADDRESS          0x40
+
+/* custom characters (codes 0 to 7 , 8 rows of 5 pixels each) */
+#define LCD_CUSTOM_CHARACTERS          8
+#define LCD_CHARACTER_ROWS             8
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
@@ -48,9 +88,17 @@
  * Initialize the LCD:
  * 1. Setup the LCD pins directions by use the GPIO driver.
  * 2. Setup the LCD Data Mode 4-bits or 8-bits.
+ * 3. In async mode start the queue writer from the timebase (TIMEBASE_init must be called first)
  */
 void LCD_init(void);
 
+/*
+ * Description :
+ * Wait till all the queued commands and data are written to the LCD
+ * (returns at once if LCD_ASYNC_ENABLE is FALSE , must not be called with interrupts disabled)
+ */
+void LCD_flush(void);
+
 /*
  * Description :
  * Send the required command to the screen
@@ -69,6 +117,12 @@ void LCD_displayCharacter(uint8 data);
  */
 void LCD_displayString(const char *Str);
 
+/*
+ * Description :
+ * Display the required string stored in flash (PROGMEM) on the screen
+ */
+void LCD_displayString_P(const char *Str);
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
@@ -81,6 +135,19 @@ void LCD_moveCursor(uint8 row,uint8 col);
  */
 void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str);
 
+/*
+ * Description :
+ * Display the required string stored in flash (PROGMEM) in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Upload a custom character pattern (LCD_CHARACTER_ROWS rows , bit 4 is the left pixel) to CGRAM ,
+ * the character is displayed with its code , move the cursor before the next display
+ */
+void LCD_createCharacter(uint8 code,const uint8 *pattern);
+
 /*
  * Description :
  * Display the required decimal value on the screen
@@ -0,0 +1,183 @@
+ /******************************************************************************
+ *
+ * Module: LCD framebuffer
+ *
+ * File Name: lcd_fb.c
+ *
+ * Description: Source file for the LCD framebuffer
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+
+#include "lcd_fb.h"
+#include "lcd.h"
+#include <avr/pgmspace.h> /* To read the flash strings */
+
+#if ((LCD_ASYNC_ENABLE == TRUE) && ((LCD_FB_ROWS*(LCD_FB_COLS+1)) >= LCD_QUEUE_SIZE))
+#error "LCD_QUEUE_SIZE must hold a full screen render"
+#endif
+
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+
+/* screen required by the application */
+static uint8 g_lcd_fb_screen[LCD_FB_ROWS][LCD_FB_COLS];
+/* screen shown on the LCD (last rendered) */
+static uint8 g_lcd_fb_shadow[LCD_FB_ROWS][LCD_FB_COLS];
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Clear the LCD once and start the framebuffer and the LCD shadow as blank
+ */
+void LCD_FB_init(void)
+{
+	uint8 row,col;
+	LCD_clearScreen();
+	for(row=0;row<LCD_FB_ROWS;row++)
+	{
+		for(col=0;col<LCD_FB_COLS;col++)
+		{
+			g_lcd_fb_screen[row][col] = ' ';
+			g_lcd_fb_shadow[row][col] = ' ';
+		}
+	}
+}
+
+/*
+ * Description :
+ * Blank the whole framebuffer
+ */
+void LCD_FB_clear(void)
+{
+	uint8 row;
+	for(row=0;row<LCD_FB_ROWS;row++)
+	{
+		LCD_FB_clearRow(row);
+	}
+}
+
+/*
+ * Description :
+ * Blank a whole row of the framebuffer
+ */
+void LCD_FB_clearRow(uint8 row)
+{
+	uint8 col;
+	if(row >= LCD_FB_ROWS)
+	{
+		return;
+	}
+	for(col=0;col<LCD_FB_COLS;col++)
+	{
+		g_lcd_fb_screen[row][col] = ' ';
+	}
+}
+
+/*
+ * Description :
+ * Put the required character in a specified row and column of the framebuffer
+ */
+void LCD_FB_writeCharacter(uint8 row,uint8 col,uint8 data)
+{
+	if((row < LCD_FB_ROWS) && (col < LCD_FB_COLS))
+	{
+		g_lcd_fb_screen[row][col] = data;
+	}
+}
+
+/*
+ * Description :
+ * Put the required string in a specified row and column of the framebuffer (cut at the row end)
+ */
+void LCD_FB_writeString(uint8 row,uint8 col,const char *Str)
+{
+	while((*Str != '\0') && (col < LCD_FB_COLS))
+	{
+		LCD_FB_writeCharacter(row,col,*Str);
+		Str++;
+		col++;
+	}
+}
+
+/*
+ * Description :
+ * Put the required string stored in flash (PROGMEM) in a specified row and column of the framebuffer
+ */
+void LCD_FB_writeString_P(uint8 row,uint8 col,const char *Str)
+{
+	uint8 data;
+	while(((data = pgm_read_byte(Str)) != '\0') && (col < LCD_FB_COLS))
+	{
+		LCD_FB_writeCharacter(row,col,data);
+		Str++;
+		col++;
+	}
+}
+
+/*
+ * Description :
+ * Replace a whole row of the framebuffer with the required string
+ */
+void LCD_FB_writeLine(uint8 row,const char *Str)
+{
+	uint8 col = 0;
+	if(row >= LCD_FB_ROWS)
+	{
+		return;
+	}
+	while((Str[col] != '\0') && (col < LCD_FB_COLS))
+	{
+		g_lcd_fb_screen[row][col] = Str[col];
+		col++;
+	}
+	for(;col<LCD_FB_COLS;col++)
+	{
+		g_lcd_fb_screen[row][col] = ' ';
+	}
+}
+
+/*
+ * Description :
+ * Replace a whole row of the framebuffer with the required string stored in flash (PROGMEM)
+ */
+void LCD_FB_writeLine_P(uint8 row,const char *Str)
+{
+	LCD_FB_clearRow(row);
+	LCD_FB_writeString_P(row,0,Str);
+}
+
+/*
+ * Description :
+ * Send the changed cells , the LCD moves its cursor to the next cell after every character
+ * so the cursor is moved only at the start of every run of changed cells
+ */
+void LCD_FB_render(void)
+{
+	uint8 row,col;
+	boolean in_run;
+	for(row=0;row<LCD_FB_ROWS;row++)
+	{
+		in_run = FALSE;
+		for(col=0;col<LCD_FB_COLS;col++)
+		{
+			if(g_lcd_fb_screen[row][col] == g_lcd_fb_shadow[row][col])
+			{
+				in_run = FALSE;
+				continue;
+			}
+			if(!in_run)
+			{
+				LCD_moveCursor(row,col);
+				in_run = TRUE;
+			}
+			LCD_displayCharacter(g_lcd_fb_screen[row][col]);
+			g_lcd_fb_shadow[row][col] = g_lcd_fb_screen[row][col];
+		}
+	}
+}
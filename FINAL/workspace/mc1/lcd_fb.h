@@ -0,0 +1,84 @@
+/******************************************************************************
+ *
+ * Module: LCD framebuffer
+ *
+ * File Name: lcd_fb.h
+ *
+ * Description: Header file for the LCD framebuffer (screen kept in RAM , only changed cells are sent to the LCD)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+
+#ifndef LCD_FB_H_
+#define LCD_FB_H_
+
+#include "std_types.h"
+#include "lcd.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* LCD size (2x16 , 4x16 or 4x20) , the columns are set by LCD_COLS of the LCD driver (row addresses) */
+#define LCD_FB_ROWS                    2
+#define LCD_FB_COLS                    LCD_COLS
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Clear the LCD once and start the framebuffer and the LCD shadow as blank (LCD_init must be called first)
+ */
+void LCD_FB_init(void);
+
+/*
+ * Description :
+ * Blank the whole framebuffer (nothing is sent till LCD_FB_render)
+ */
+void LCD_FB_clear(void);
+
+/*
+ * Description :
+ * Blank a whole row of the framebuffer
+ */
+void LCD_FB_clearRow(uint8 row);
+
+/*
+ * Description :
+ * Put the required character in a specified row and column of the framebuffer
+ */
+void LCD_FB_writeCharacter(uint8 row,uint8 col,uint8 data);
+
+/*
+ * Description :
+ * Put the required string in a specified row and column of the framebuffer (cut at the row end)
+ */
+void LCD_FB_writeString(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Put the required string stored in flash (PROGMEM) in a specified row and column of the framebuffer
+ */
+void LCD_FB_writeString_P(uint8 row,uint8 col,const char *Str);
+
+/*
+ * Description :
+ * Replace a whole row of the framebuffer with the required string (rest of the row is blanked)
+ */
+void LCD_FB_writeLine(uint8 row,const char *Str);
+
+/*
+ * Description :
+ * Replace a whole row of the framebuffer with the required string stored in flash (PROGMEM)
+ */
+void LCD_FB_writeLine_P(uint8 row,const char *Str);
+
+/*
+ * Description :
+ * Send the framebuffer cells that differ from the LCD , with one cursor move per run of changed cells
+ */
+void LCD_FB_render(void);
+
+#endif /* LCD_FB_H_ */
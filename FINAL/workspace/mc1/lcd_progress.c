@@ -0,0 +1,102 @@
+ /******************************************************************************
+ *
+ * Module: LCD progress
+ *
+ * File Name: lcd_progress.c
+ *
+ * Description: Source file for the LCD countdown and progress bar widget
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+
+#include "lcd_progress.h"
+#include "lcd_fb.h"
+#include "lcd.h"
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Upload one glyph for every partly or fully filled cell (left pixel columns lit , top and bottom rows blank)
+ */
+void LCD_PROGRESS_init(void)
+{
+	uint8 pixels,row;
+	uint8 pattern[LCD_CHARACTER_ROWS];
+	for(pixels=1;pixels<=LCD_PROGRESS_CELL_PIXELS;pixels++)
+	{
+		for(row=0;row<LCD_CHARACTER_ROWS;row++)
+		{
+			if((row == 0) || (row == (LCD_CHARACTER_ROWS-1)))
+			{
+				pattern[row] = 0;
+			}
+			else
+			{
+				pattern[row] = (uint8)(0x1F << (LCD_PROGRESS_CELL_PIXELS-pixels)) & 0x1F;
+			}
+		}
+		LCD_createCharacter(LCD_PROGRESS_FIRST_CODE+pixels-1,pattern);
+	}
+}
+
+/*
+ * Description :
+ * Draw the bar and the remaining seconds in the framebuffer
+ */
+void LCD_PROGRESS_show(uint8 row,uint16 remaining,uint16 total)
+{
+	uint16 filled;
+	uint8 cell,col;
+	uint8 unit = 's';
+
+	if(remaining > total)
+	{
+		remaining = total;
+	}
+	/* filled pixel columns of the whole bar */
+	filled = (total == 0) ? 0 :
+			(uint16)(((uint32)(total-remaining)*(LCD_PROGRESS_BAR_CELLS*LCD_PROGRESS_CELL_PIXELS))/total);
+
+	for(cell=0;cell<LCD_PROGRESS_BAR_CELLS;cell++)
+	{
+		if(filled >= LCD_PROGRESS_CELL_PIXELS)
+		{
+			LCD_FB_writeCharacter(row,cell,LCD_PROGRESS_FIRST_CODE+LCD_PROGRESS_CELL_PIXELS-1);
+			filled -= LCD_PROGRESS_CELL_PIXELS;
+		}
+		else if(filled > 0)
+		{
+			LCD_FB_writeCharacter(row,cell,LCD_PROGRESS_FIRST_CODE+filled-1);
+			filled = 0;
+		}
+		else
+		{
+			LCD_FB_writeCharacter(row,cell,' ');
+		}
+	}
+
+	/* more seconds than the text cells hold : minutes (rounded up) */
+	if(remaining > 999)
+	{
+		remaining = (remaining+59)/60;
+		unit = 'm';
+	}
+	/* remaining seconds right aligned , leading zeros are blank */
+	col = LCD_PROGRESS_BAR_CELLS+LCD_PROGRESS_TEXT_CELLS-1;
+	LCD_FB_writeCharacter(row,col,unit);
+	do
+	{
+		col--;
+		LCD_FB_writeCharacter(row,col,'0'+(remaining%10));
+		remaining /= 10;
+	} while(remaining > 0);
+	while(col > LCD_PROGRESS_BAR_CELLS)
+	{
+		col--;
+		LCD_FB_writeCharacter(row,col,' ');
+	}
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *
+ * Module: LCD progress
+ *
+ * File Name: lcd_progress.h
+ *
+ * Description: Header file for the LCD countdown and progress bar widget (drawn in the LCD framebuffer)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+
+#ifndef LCD_PROGRESS_H_
+#define LCD_PROGRESS_H_
+
+#include "std_types.h"
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+/* bar cells from column 0 , then the remaining seconds right aligned ("NNNs" , "NNm" above 999 seconds) */
+#define LCD_PROGRESS_BAR_CELLS         12
+#define LCD_PROGRESS_TEXT_CELLS        4
+
+/* pixel columns of one character cell */
+#define LCD_PROGRESS_CELL_PIXELS       5
+
+/* custom character of a cell with 1 to 5 filled pixel columns is (LCD_PROGRESS_FIRST_CODE + pixels - 1) */
+#define LCD_PROGRESS_FIRST_CODE        1
+
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+
+/*
+ * Description :
+ * Upload the bar glyphs to the LCD CGRAM (once , after LCD_init)
+ */
+void LCD_PROGRESS_init(void);
+
+/*
+ * Description :
+ * Draw the elapsed part of total seconds as a bar and the remaining seconds as text in the required framebuffer row
+ * (only the changed cells are sent by the next LCD_FB_render)
+ */
+void LCD_PROGRESS_show(uint8 row,uint16 remaining,uint16 total);
+
+#endif /* LCD_PROGRESS_H_ */
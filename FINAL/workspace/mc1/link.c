@@ -0,0 +1,259 @@
+/******************************************************************************
+ *
+ * Module: link
+ *
+ * File Name: link.c
+ *
+ * Description: Source file for the authenticated and encrypted link between the two microcontrollers
+ *              (Ascon-128 frames over the UART)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"link.h"
+#include"ascon.h"
+#include"uart.h"
+#include"timestamp.h"
+#include <avr/io.h> /* To use E2END */
+#include <avr/eeprom.h>
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+#define LINK_PEER_NODE            ((LINK_NODE==LINK_NODE_MC1)?LINK_NODE_MC2:LINK_NODE_MC1)
+/* the key is in the last bytes of the internal EEPROM , out of the EEMEM variables of the build ,
+ * so programming the .eep of the build doesn't erase it
+ */
+#define LINK_KEY_EEPROM_ADDRESS   (E2END+1-ASCON_KEY_SIZE)
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* boot counter of this microcontroller */
+static uint32 EEMEM g_link_bootEeprom=0;
+static uint8 g_link_key[ASCON_KEY_SIZE];
+/* counter of the next sent frame */
+static uint32 g_link_boot=0;
+static uint32 g_link_count=0;
+/* counter of the last frame accepted from the other microcontroller */
+static uint32 g_link_peerBoot=0;
+static uint32 g_link_peerCount=0;
+/* challenges made since the boot */
+static uint16 g_link_challengeCount=0;
+/* challenge of the current transaction (associated data of the frames) */
+static uint8 g_link_challenge[LINK_CHALLENGE_SIZE];
+static uint8 g_link_challengeSize=0;
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: Function to build the nonce of a frame : sender node , zeros , frame counter
+ */
+static void LINK_nonce(uint8 * nonce_ptr,uint8 node,const uint8 * counter_ptr)
+{
+	uint8 i;
+	nonce_ptr[0]=node;
+	for(i=1;i<(ASCON_NONCE_SIZE-LINK_COUNTER_SIZE);i++)
+	{
+		nonce_ptr[i]=0;
+	}
+	for(i=0;i<LINK_COUNTER_SIZE;i++)
+	{
+		nonce_ptr[ASCON_NONCE_SIZE-LINK_COUNTER_SIZE+i]=counter_ptr[i];
+	}
+}
+/*
+ * Description: Function to read 4 bytes (big endian)
+ */
+static uint32 LINK_getWord(const uint8 * bytes_ptr)
+{
+	return ((uint32)bytes_ptr[0]<<24)|((uint32)bytes_ptr[1]<<16)|((uint32)bytes_ptr[2]<<8)|bytes_ptr[3];
+}
+/*
+ * Description: Function to write 4 bytes (big endian)
+ */
+static void LINK_putWord(uint8 * bytes_ptr,uint32 word)
+{
+	bytes_ptr[0]=(uint8)(word>>24);
+	bytes_ptr[1]=(uint8)(word>>16);
+	bytes_ptr[2]=(uint8)(word>>8);
+	bytes_ptr[3]=(uint8)word;
+}
+/*
+ *  Description : Function to initialize the link (after UART_init)
+ * 	1. read the key from the last ASCON_KEY_SIZE bytes of the internal EEPROM
+ * 	2. increment the boot counter in the internal EEPROM (nonces are never used again after a reset)
+ * 	FALSE if no key is programmed (all bytes 0xFF or all 0)
+ */
+boolean LINK_init(void)
+{
+	uint8 erased=0xFF; /*AND of the key bytes*/
+	uint8 zero=0x00; /*OR of the key bytes*/
+	uint8 i;
+	eeprom_read_block(g_link_key,(const void *)LINK_KEY_EEPROM_ADDRESS,ASCON_KEY_SIZE);
+	for(i=0;i<ASCON_KEY_SIZE;i++)
+	{
+		erased&=g_link_key[i];
+		zero|=g_link_key[i];
+	}
+	if((erased==0xFF)||(zero==0x00))
+	{
+		return FALSE;
+	}
+	g_link_boot=eeprom_read_dword(&g_link_bootEeprom);
+	if(g_link_boot==0xFFFFFFFF)
+	{
+		/* erased EEPROM */
+		g_link_boot=0;
+	}
+	g_link_boot++;
+	eeprom_update_dword(&g_link_bootEeprom,g_link_boot);
+	g_link_count=0;
+	return TRUE;
+}
+/*
+ * Description: Function to encrypt and send one message of (length) bytes (up to LINK_MAX_PAYLOAD)
+ */
+void LINK_send(const uint8 * payload_ptr,uint8 length)
+{
+	uint8 counter[LINK_COUNTER_SIZE];
+	uint8 nonce[ASCON_NONCE_SIZE];
+	uint8 cipher[LINK_MAX_PAYLOAD];
+	uint8 tag[ASCON_TAG_SIZE];
+	uint8 i;
+	if(length>LINK_MAX_PAYLOAD)
+	{
+		length=LINK_MAX_PAYLOAD;
+	}
+	g_link_count++;
+	LINK_putWord(counter,g_link_boot);
+	LINK_putWord(counter+4,g_link_count);
+	LINK_nonce(nonce,LINK_NODE,counter);
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_LINK_CRYPTO);
+	ASCON_encrypt(g_link_key,nonce,g_link_challenge,g_link_challengeSize,payload_ptr,cipher,length,tag);
+	TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_LINK_CRYPTO);
+	UART_sendByte(LINK_SOF);
+	UART_sendByte(length);
+	for(i=0;i<LINK_COUNTER_SIZE;i++)
+	{
+		UART_sendByte(counter[i]);
+	}
+	for(i=0;i<length;i++)
+	{
+		UART_sendByte(cipher[i]);
+	}
+	for(i=0;i<LINK_TAG_SIZE;i++)
+	{
+		UART_sendByte(tag[i]);
+	}
+}
+/*
+ * Description: Function to wait for the next authentic message
+ * frames with a wrong tag or an old counter (replayed) are dropped
+ */
+uint8 LINK_receive(uint8 * payload_ptr,uint8 max_length)
+{
+	uint8 counter[LINK_COUNTER_SIZE];
+	uint8 nonce[ASCON_NONCE_SIZE];
+	uint8 message[LINK_MAX_PAYLOAD];
+	uint8 tag[LINK_TAG_SIZE];
+	uint8 length;
+	uint32 boot;
+	uint32 count;
+	boolean authentic;
+	uint8 i;
+	while(1)
+	{
+		/* start of frame */
+		while(UART_recieveByte()!=LINK_SOF){}
+		length=UART_recieveByte();
+		if(length>LINK_MAX_PAYLOAD)
+		{
+			continue;
+		}
+		for(i=0;i<LINK_COUNTER_SIZE;i++)
+		{
+			counter[i]=UART_recieveByte();
+		}
+		for(i=0;i<length;i++)
+		{
+			message[i]=UART_recieveByte();
+		}
+		for(i=0;i<LINK_TAG_SIZE;i++)
+		{
+			tag[i]=UART_recieveByte();
+		}
+		/* replayed frame : counter not after the last accepted one */
+		boot=LINK_getWord(counter);
+		count=LINK_getWord(counter+4);
+		if((boot<g_link_peerBoot)||((boot==g_link_peerBoot)&&(count<=g_link_peerCount)))
+		{
+			continue;
+		}
+		LINK_nonce(nonce,LINK_PEER_NODE,counter);
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_LINK_CRYPTO);
+		authentic=ASCON_decrypt(g_link_key,nonce,g_link_challenge,g_link_challengeSize,message,message,length,tag,LINK_TAG_SIZE);
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_LINK_CRYPTO);
+		if(authentic)
+		{
+			g_link_peerBoot=boot;
+			g_link_peerCount=count;
+			for(i=0;(i<length)&&(i<max_length);i++)
+			{
+				payload_ptr[i]=message[i];
+			}
+			return length;
+		}
+	}
+}
+/*
+ * Description: Function to send a one byte message
+ */
+void LINK_sendByte(uint8 data)
+{
+	LINK_send(&data,1);
+}
+/*
+ * Description: Function to wait for the next authentic message and return its first byte
+ */
+uint8 LINK_receiveByte(void)
+{
+	uint8 data=0;
+	LINK_receive(&data,1);
+	return data;
+}
+/*
+ * Description: Function to make a fresh challenge for a transaction (never repeated , even after a reset)
+ * 	1. boot counter (internal EEPROM) : unique across resets
+ * 	2. challenge counter : unique in this boot
+ * 	3. low bits of the timestamp counter : jitter of the time the transaction started
+ */
+void LINK_newChallenge(uint8 * challenge_ptr)
+{
+	uint32 now=TIMESTAMP_now();
+	g_link_challengeCount++;
+	LINK_putWord(challenge_ptr,g_link_boot);
+	challenge_ptr[4]=(uint8)(g_link_challengeCount>>8);
+	challenge_ptr[5]=(uint8)g_link_challengeCount;
+	challenge_ptr[6]=(uint8)(now>>8);
+	challenge_ptr[7]=(uint8)now;
+}
+/*
+ * Description: Function to bind the next frames (sent and received) to a transaction challenge
+ * a frame recorded in another transaction fails authentication , NULL_PTR ends the binding
+ */
+void LINK_bind(const uint8 * challenge_ptr)
+{
+	uint8 i;
+	if(challenge_ptr==NULL_PTR)
+	{
+		g_link_challengeSize=0;
+		return;
+	}
+	for(i=0;i<LINK_CHALLENGE_SIZE;i++)
+	{
+		g_link_challenge[i]=challenge_ptr[i];
+	}
+	g_link_challengeSize=LINK_CHALLENGE_SIZE;
+}
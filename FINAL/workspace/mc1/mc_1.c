@@ -12,14 +12,20 @@
 /*******************************************************************************
  *                                includes                                 *
  *******************************************************************************/
-/* define frequency of processor to 8MGZ */
+/* define frequency of processor to 8MGZ (normally given to all files by the build -DF_CPU) */
+#ifndef F_CPU
 #define F_CPU 8000000UL
-#include <util/delay.h> /*to use (_delay_ms(value)) */
-#include"timer0.h"
+#endif
+#include"timebase.h"
+#include"timestamp.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include"keypad.h"
 #include"lcd.h"
+#include"lcd_fb.h"
+#include"lcd_progress.h"
 #include"uart.h"
+#include"link.h"
 #include"std_types.h"
 /*******************************************************************************
  *                                macros                                   *
@@ -28,26 +34,45 @@
 #define DONE                             0  /* password is done */
 #define MC1_READY                        0x20
 #define MC2_READY                        0x10
-#define PASS_SIZE                        5  /*refer to size of password*/
+/* start up query : microcontroller2 answers if a password is stored (before the transaction handshake) */
+#define MC1_PASS_QUERY                   0x21
+#define PASS_STORED                      0x11
+#define PASS_NOT_STORED                  0x12
+/* password : 4 to 16 digits in packed BCD (first digit in the high nibble of the first byte) ,
+ * the nibbles after the last digit are PASS_NO_DIGIT
+ */
+#define PASS_MIN_DIGITS                  4
+#define PASS_MAX_DIGITS                  16
+#define PASS_SIZE                        (PASS_MAX_DIGITS/2)  /*refer to size of password*/
+#define PASS_NO_DIGIT                    0x0F
 #define WRONG_PASSWORD                   0
 #define TRUE_PASSWORD                    1
-/*for one second :need 64 overflow (interrupt)*/
-/* why 32 : (1024/(8*10^6))*250*(10^3)
- * where  1024   :  prescaler
- *        8*10^6 :  F_cpu
- *        10^3   :  one second
- *        250    :  number of interrupts
+/* wrong password or attempt in a lockout : microcontroller2 counts the failed attempts (kept over a power off)
+ * and sends this verdict when it locks out , the lockout status events follow
  */
-
-#define NUMBER_OF_OVERFLOWS_for_1_SECOND 32
+#define LOCKED_OUT                       2
+/* status events published by microcontroller2 when the motor or lockout state changes
+ * (values kept away from MC1_READY/MC2_READY and the password verdicts)
+ */
+#define STATUS_DOOR_OPENING              0x30
+#define STATUS_DOOR_OPEN                 0x31
+#define STATUS_DOOR_CLOSING              0x32
+#define STATUS_DOOR_CLOSED               0x33
+#define STATUS_LOCKOUT_ON                0x34
+#define STATUS_LOCKOUT_OFF               0x35
+/* countdown event : followed by two bytes (high byte first) of the seconds left till the door is closed or the lockout ends */
+#define STATUS_COUNTDOWN                 0x36
+/* obstruction event : the door motor stalled , microcontroller2 stops or reverses it (a new countdown follows) */
+#define STATUS_DOOR_OBSTRUCTED           0x37
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 /*
  * Description: Function for initialize  all drivers
  *  1)Enable global interrupts
- *  2)LCD
- *  3)UART
+ *  2)timebase , timestamp and keypad scanner
+ *  3)LCD and its framebuffer
+ *  4)UART and link
  */
 void init_microcontroller(void);
 /*
@@ -56,11 +81,17 @@ void init_microcontroller(void);
  *         [in]   : pointer to array where I will store password in (global array)
  */
 void set_password(uint8 * passArray_ptr);
+/*
+ * Description: Function to ask microcontroller2 at start up if a password is stored
+ * [Args] :
+ *         [out]  : TRUE if a password is stored (FALSE : first start up , set the password)
+ */
+boolean password_is_stored(void);
 /*
  * Description: Function to take the password from user at beginning of system (first time)
  * [Args] :
  *         [in]   : pointer to array where I will store password in (global array)
- *         [out]  :    DONE  : mean that the user enter password with same PASS_SIZE
+ *         [out]  :    DONE  : mean that the user enter PASS_MIN_DIGITS to PASS_MAX_DIGITS digits
  *                             and pressed enter after password
  *                  or Error : reverse of case Done
  */
@@ -73,6 +104,28 @@ uint8 take_password_at_first_time(uint8 * passArray_ptr);
  *                  or Error : reverse of case Done
  */
 uint8 confirm_password_at_first(uint8 * passArray_ptr);
+/*
+ * Description: Function to clear the password (all nibbles PASS_NO_DIGIT)
+ * [Args] :
+ *         [in]   : pointer to array where I will store password in (global array)
+ */
+void clear_password(uint8 * passArray_ptr);
+/*
+ * Description: Function to store one digit of the password
+ * [Args] :
+ *         [in]   : pointer to array where I will store password in (global array)
+ *         [in]   : index of the digit (0 to PASS_MAX_DIGITS-1)
+ *         [in]   : digit (0 to 9)
+ */
+void set_password_digit(uint8 * passArray_ptr,uint8 index,uint8 digit);
+/*
+ * Description: Function to read one digit of the password
+ * [Args] :
+ *         [in]   : pointer to array where I will store password in (global array)
+ *         [in]   : index of the digit (0 to PASS_MAX_DIGITS-1)
+ *         [out]  : digit or PASS_NO_DIGIT after the last digit
+ */
+uint8 get_password_digit(const uint8 * passArray_ptr,uint8 index);
 /*
  * Description: Function to sent the password to microcontroller2 using UART
  * [Args] :
@@ -95,95 +148,59 @@ void enter_pass(uint8 * passArray_ptr);
 /*
  * Description: Function to interfacing with microcontroller2
  *                          if password is true : open door or change password
- *                                          else: wait 1 minute
+ *                                          else: enter it again till microcontroller2 locks out
  * [Args] :
  *         [in]   : pointer to array where I will store password in (global array)
  */
 void options(uint8 * passArray_ptr);
 /*
- * Description:Function for
- *           1) waiting till the buzzer be off (60 seconds)
- *              when user enter password three times wrong
- *              by set timer0 to calculate 60 seconds
- *           2) show error massage on LCD for 60 seconds
- *           3) set timer call (wrong_password_off) after counting 60 seconds
- */
-void wrong_password_on(void);
-/*
- * Description: Function for waiting till the motor be off (33 seconds)
- * when user enter password and choose option '+'
+ * Description: Function to render the status events published by microcontroller2
+ * (door opening/open/closing/closed/obstructed , lockout on/off) on LCD as they arrive
+ * and the countdown events as a progress bar with the seconds left in the second line
+ * [Args] :
+ *         [in]   : status event that ends the sequence (STATUS_DOOR_CLOSED or STATUS_LOCKOUT_OFF)
  */
-void waiting_motor_on(void);
+void show_door_status(uint8 last_status);
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
-/* array of size PASS_SIZE elements to hold password */
+/* array of size PASS_SIZE elements to hold password (two digits per element) */
 uint8 pass_array[PASS_SIZE];
-/* Global variable to counting times of run Ultrasonic_edgeProcessing function
- *  */
-uint16 g_tick=0;
+/* UI strings kept in flash (shown with the _P functions , not copied to SRAM at start up) */
+const char str_enter_new_pass[] PROGMEM     = "Enter N_Password";
+const char str_reenter_new_pass[] PROGMEM   = "RE-Enter N_Pass";
+const char str_option_open[] PROGMEM        = "+: open door";
+const char str_option_change[] PROGMEM      = "-:change pass";
+const char str_enter_pass[] PROGMEM         = "Enter Password:";
+const char str_door_opening[] PROGMEM       = "Door is opening";
+const char str_door_open[] PROGMEM          = "Door is stop";
+const char str_door_closing[] PROGMEM       = "Door is closing";
+const char str_lockout[] PROGMEM            = "Error";
+const char str_door_obstructed[] PROGMEM    = "Door obstructed";
+const char str_no_link_key[] PROGMEM        = "No link key";
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
-/*
- * Description: Function for call back for timer0
- * to deinit timer0 and clear lcd from error message
- */
-void wrong_password_off(void)
-{
-	g_tick++; /*if NUMBER_OF_OVERFLOWS_for_1_SECOND occur so counter will added by 1 */
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*60)
-	{
-		g_tick=0; /*clear counter to count from 0 again*/
-		TIMER_0_deInit(); /*turn off timer*/
-	}
-}
-/*
- * Description: Function for call back for timer0
- * to deinit timer0
- * and show case of motor (open ,stop,close)
- */
-void waiting_motor_off(void)
-{
-	g_tick++; /*if NUMBER_OF_OVERFLOWS_for_1_SECOND occur so counter will added by 1 */
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*15)
-	{
-		/*clear LCD */
-		LCD_clearScreen();
-		/*use LCD to print message : "door is stop" */
-		LCD_displayString("Door is stop");
-	}
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*18)
-	{
-		/*clear LCD */
-		LCD_clearScreen();
-		/*use LCD to print message : "door is closing" */
-		LCD_displayString("Door is closing");
-
-	}
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*33)
-	{
-		TIMER_0_deInit();/*turn off timer*/
-		g_tick=0;/*clear counter to count from 0 again*/
-
-	}
-}
 /*
  * Description: main Function
  *  1)initialize  all drivers
- *  2)set password at first time
- *  3)sent password to microcontroller2 using UART
- *  4)show options in while(1)
+ *  2)no password stored in microcontroller2 (first start up) :
+ *    set password and sent it to microcontroller2 using UART
+ *  3)show options in while(1)
  */
 int main(void)
 {
 	/*initialize  all drivers */
 	init_microcontroller();
 
-	/*set password at first time */
-	set_password(pass_array);
-	/* sent password to microcontroller2*/
-	sent_password_using_uart(pass_array);
+	/*a stored password is changed only by option '-' after the old password (not by a reset)*/
+	if (!password_is_stored())
+	{
+		/*set password at first time */
+		set_password(pass_array);
+		/* sent password to microcontroller2*/
+		sent_password_using_uart(pass_array);
+	}
 	while(1)
 	{
 		/* show  main options*/
@@ -193,20 +210,35 @@ int main(void)
 /*
  * Description: Function for initialize  all drivers
  *  1)Enable global interrupts
- *  2)LCD
- *  3)UART
+ *  2)timebase , timestamp and keypad scanner
+ *  3)LCD and its framebuffer
+ *  4)UART and link
  */
 void init_microcontroller(void)
 {
 	/*Enable global interrupts in MC by setting the I-Bit.*/
 	SREG |= (1<<7);
+	/*initialize the ms timebase and the cycle timestamps*/
+	TIMEBASE_init();
+	TIMESTAMP_init();
+	/*start the debounced keypad scanner*/
+	KEYPAD_init();
 	/*initialize the LCD*/
 	LCD_init();
-	/*clear LCD */
-	LCD_clearScreen();
-	/*initialize the UART*/
+	/*clear LCD and start the screen framebuffer*/
+	LCD_FB_init();
+	/*upload the progress bar glyphs*/
+	LCD_PROGRESS_init();
+	/*initialize the UART and the encrypted link to microcontroller2 on it*/
 	s_uart_ConfigType conf_1={_8_BITS_SIZE,DISABLED_PARITY,_1_BIT_STOP,9600};
 	UART_init(&conf_1);
+	if(!LINK_init())
+	{
+		/*the key is not programmed (link_key.py) , nothing is sent to microcontroller2 without it*/
+		LCD_FB_writeLine_P(0,str_no_link_key);
+		LCD_FB_render();
+		while(1){}
+	}
 }
 /*
  * Description: Function to take the password from user at beginning of system in two times
@@ -224,50 +256,64 @@ void set_password(uint8 * passArray_ptr)
 	} while (confirm_password_at_first(passArray_ptr));
 	/* function (confirm_password) return 1 in case not matching  or 0 in case  matching */
 }
+/*
+ * Description: Function to ask microcontroller2 at start up if a password is stored
+ * [Args] :
+ *         [out]  : TRUE if a password is stored (FALSE : first start up , set the password)
+ */
+boolean password_is_stored(void)
+{
+	uint8 reply; /*PASS_STORED or PASS_NOT_STORED*/
+	LINK_bind(NULL_PTR);
+	LINK_sendByte(MC1_PASS_QUERY);
+	do
+	{
+		reply=LINK_receiveByte();
+	} while ((reply!=PASS_STORED)&&(reply!=PASS_NOT_STORED));
+	return (reply==PASS_STORED);
+}
 /*
  * Description: Function to take the password from user at beginning of system (first time)
  * [Args] :
  *         [in]   : pointer to array where I will store password in (global array)
- *         [out]  :    DONE  : mean that the user enter password with same PASS_SIZE
+ *         [out]  :    DONE  : mean that the user enter PASS_MIN_DIGITS to PASS_MAX_DIGITS digits
  *                             and pressed enter after password
  *                  or Error : reverse of case Done
  */
 uint8 take_password_at_first_time(uint8 * passArray_ptr)
 {
-	uint8 loop_count=0; /*counter to use it in for_loop*/
+	uint8 length=0; /*digits entered*/
 	uint8 key; /*to hold the value return of keypad*/
-	/*clear LCD */
-	LCD_clearScreen();
-	/*use LCD to print message : "enter pass" */
-	LCD_displayString("Enter N_Password");
-	/* move the cursor of LCD to print the pass as ***** */
-	LCD_moveCursor(1,0);
-	/* for_loop counts from 0 to size of password
-	 * where: from (loop_count=0)   to (loop_count=PASS_SIZE-1) take password from user
-	 *        final COUNT (loop_count=PASS_SIZE) for take (>>enter<< (ON/C)) from user
-	 */
-	for (;loop_count<=(PASS_SIZE);loop_count++)
+	/*use LCD to print message : "enter pass" , the pass is printed as ***** in the second line*/
+	LCD_FB_writeLine_P(0,str_enter_new_pass);
+	LCD_FB_clearRow(1);
+	LCD_FB_render();
+	clear_password(passArray_ptr);
+	while(1)
 	{
-		/* Press time for keypad */
-		_delay_ms(500);
 		/* take elements of password using Keypad */
 		key=KEYPAD_getPressedKey();
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_KEY_TO_ECHO);
 
-		/*make sure that the user  enter password as size
-		 * 13 : ASCII of >>enter<< (ON/C)
-		 */
-		if (((loop_count<PASS_SIZE)&&(13==key))||((loop_count==PASS_SIZE)&&(13!=key)))
-			return ERROR;
-		/* store the element in array and show '*'
-		 * but first doesn't include  >>enter<< (ON/C) in password
+		/*make sure that the user enter PASS_MIN_DIGITS digits at least
+		 * KEYPAD_KEY_ENTER : >>enter<< (ON/C)
 		 */
-		if ((loop_count!=PASS_SIZE))
+		if (KEYPAD_KEY_ENTER==key)
+		{
+			return (length<PASS_MIN_DIGITS)?ERROR:DONE;
+		}
+		/* only digits are part of the password*/
+		if (KEYPAD_IS_DIGIT(key))
 		{
-			LCD_displayCharacter('*'); /* display * for every digit enter*/
-			*(passArray_ptr+loop_count)=key;  /* store digits in array*/
+			if (length==PASS_MAX_DIGITS)
+				return ERROR;
+			LCD_FB_writeCharacter(1,length,'*'); /* display * for every digit enter*/
+			LCD_FB_render();
+			TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_KEY_TO_ECHO);
+			set_password_digit(passArray_ptr,length,key);  /* store digits in array*/
+			length++;
 		}
 	}
-	return DONE ;
 }
 /*
  * Description: Function to take the password from user at beginning of system (second time)
@@ -278,42 +324,88 @@ uint8 take_password_at_first_time(uint8 * passArray_ptr)
  */
 uint8 confirm_password_at_first(uint8 * passArray_ptr)
 {
-	uint8 loop_count=-1; /*counter to use it in for_loop*/
+	uint8 length=0; /*digits entered*/
 	uint8 key; /*to hold the value return of keypad*/
 	uint8 wrong=0; /*as flag will equal 1 if element at least wrong*/
 
-	/*clear LCD */
-	LCD_clearScreen();
-	/*use LCD to print message : "enter pass" */
-	LCD_displayString("RE-Enter N_Pass");
-	/* move the cursor of LCD to print the pass as ***** */
-	LCD_moveCursor(1,0);
+	/*use LCD to print message : "enter pass" , the pass is printed as ***** in the second line*/
+	LCD_FB_writeLine_P(0,str_reenter_new_pass);
+	LCD_FB_clearRow(1);
+	LCD_FB_render();
 	do
 	{
-		loop_count++;
-		/* Press time for keypad */
-		_delay_ms(500);
 		/* take elements of password using Keypad */
 		key=KEYPAD_getPressedKey();
-		/* wrong will be set if user enter password's length not equal password's length at first time */
-		if (((loop_count<PASS_SIZE)&&(13==key))||((loop_count<PASS_SIZE)&&(*(passArray_ptr+loop_count)!=key)))
-		{
-			wrong=1;
-		}
-		if (key!=13)
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_KEY_TO_ECHO);
+		/* only digits are part of the password*/
+		if (KEYPAD_IS_DIGIT(key))
 		{
-			LCD_displayCharacter('*'); /* display * for every digit enter*/
+			/* wrong will be set if a digit is not equal the digit at first time */
+			if (get_password_digit(passArray_ptr,length)!=key)
+			{
+				wrong=1;
+			}
+			LCD_FB_writeCharacter(1,length,'*'); /* display * for every digit enter*/
+			LCD_FB_render();
+			TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_KEY_TO_ECHO);
+			length++;
 		}
-	} while ((key!=13)&&(loop_count<16));
+	} while ((key!=KEYPAD_KEY_ENTER)&&(length<PASS_MAX_DIGITS));
 	/* not matched in three cases
 	 * 1)second time 's length is less than at first
-	 * 2)second time 's length is large than at first
+	 * 2)second time 's length is large than at first (no enter after PASS_MAX_DIGITS digits)
 	 * 3)second time not matched with first
 	 * */
-	if ((loop_count>PASS_SIZE)||(wrong==1))
+	if ((key!=KEYPAD_KEY_ENTER)&&(KEYPAD_getPressedKey()!=KEYPAD_KEY_ENTER))
+		wrong=1;
+	if ((length<PASS_MAX_DIGITS)&&(get_password_digit(passArray_ptr,length)!=PASS_NO_DIGIT))
+		wrong=1;
+	if (wrong==1)
 		return ERROR  ;
 	return DONE  ;
 }
+/*
+ * Description: Function to clear the password (all nibbles PASS_NO_DIGIT)
+ * [Args] :
+ *         [in]   : pointer to array where I will store password in (global array)
+ */
+void clear_password(uint8 * passArray_ptr)
+{
+	uint8 loop_count; /*counter to use it in for_loop*/
+	for (loop_count=0;loop_count<PASS_SIZE;loop_count++)
+	{
+		passArray_ptr[loop_count]=(PASS_NO_DIGIT<<4)|PASS_NO_DIGIT;
+	}
+}
+/*
+ * Description: Function to store one digit of the password
+ * [Args] :
+ *         [in]   : pointer to array where I will store password in (global array)
+ *         [in]   : index of the digit (0 to PASS_MAX_DIGITS-1)
+ *         [in]   : digit (0 to 9)
+ */
+void set_password_digit(uint8 * passArray_ptr,uint8 index,uint8 digit)
+{
+	if (index&1)
+	{
+		passArray_ptr[index/2]=(passArray_ptr[index/2]&0xF0)|digit;
+	}
+	else
+	{
+		passArray_ptr[index/2]=(passArray_ptr[index/2]&0x0F)|(uint8)(digit<<4);
+	}
+}
+/*
+ * Description: Function to read one digit of the password
+ * [Args] :
+ *         [in]   : pointer to array where I will store password in (global array)
+ *         [in]   : index of the digit (0 to PASS_MAX_DIGITS-1)
+ *         [out]  : digit or PASS_NO_DIGIT after the last digit
+ */
+uint8 get_password_digit(const uint8 * passArray_ptr,uint8 index)
+{
+	return (index&1)?(passArray_ptr[index/2]&0x0F):(passArray_ptr[index/2]>>4);
+}
 /*
  * Description: Function to sent the password to microcontroller2 using UART
  * [Args] :
@@ -321,20 +413,19 @@ uint8 confirm_password_at_first(uint8 * passArray_ptr)
  */
 void sent_password_using_uart(uint8 * passArray_ptr)
 {
-	uint8 loop_count; /*counter to use it in for_loop*/
+	uint8 ready[1+LINK_CHALLENGE_SIZE]; /*MC2_READY then the challenge of this transaction*/
 
 	/*you can delete this check */
 
-	/*for checking that two microcontrollers working in same time */
-	UART_sendByte(MC1_READY);
-	while(UART_recieveByte() != MC2_READY){}
+	/*for checking that two microcontrollers working in same time (new transaction)*/
+	LINK_bind(NULL_PTR);
+	LINK_sendByte(MC1_READY);
+	while((LINK_receive(ready,sizeof(ready))!=sizeof(ready))||(ready[0]!=MC2_READY)){}
+	/*the password , the verdict and the option are bound to the challenge (a recorded command is not accepted again)*/
+	LINK_bind(&ready[1]);
 
-	/* sent password to  store it in EEPROM*/
-	for (loop_count=0;loop_count<PASS_SIZE;loop_count++)
-	{
-		/* Send the required string to MC2 through UART */
-		UART_sendByte(passArray_ptr[loop_count]);
-	}
+	/* sent password to  store it in EEPROM (one encrypted frame)*/
+	LINK_send(passArray_ptr,PASS_SIZE);
 }
 /*
  * Description: Function to show options on LCD
@@ -345,15 +436,12 @@ void sent_password_using_uart(uint8 * passArray_ptr)
 uint8 show_options(void)
 {
 	uint8 option ; /*TO hold + or - */
+	/*use LCD to print the options (drawn once , invalid keys don't redraw it)*/
+	LCD_FB_writeLine_P(0,str_option_open);
+	LCD_FB_writeLine_P(1,str_option_change);
+	LCD_FB_render();
 	do
 	{
-		/*clear LCD */
-		LCD_clearScreen();
-		/*use LCD to print message : "enter pass" */
-		LCD_displayString("+: open door  ");
-		/* move the cursor of LCD to print the pass as ***** */
-		LCD_moveCursor(1,0);
-		LCD_displayString("-:change pass ");
 		/* take elements of password using Keypad */
 		option=KEYPAD_getPressedKey();
 	} while ((option!='+')&&(option!='-'));
@@ -366,91 +454,69 @@ uint8 show_options(void)
  */
 void enter_pass(uint8 * passArray_ptr)
 {
-	uint8 loop_count=-1; /*counter to use it in for_loop*/
+	uint8 length=0; /*digits entered*/
 	uint8 key; /*to hold the value return of keypad*/
 
-	/*clear LCD */
-	LCD_clearScreen();
-	/*use LCD to print message : "enter pass" */
-	LCD_displayString("Enter Password:");
-	/* move the cursor of LCD to print the pass as ***** */
-	LCD_moveCursor(1,0);
+	/*use LCD to print message : "enter pass" , the pass is printed as ***** in the second line*/
+	LCD_FB_writeLine_P(0,str_enter_pass);
+	LCD_FB_clearRow(1);
+	LCD_FB_render();
+	clear_password(passArray_ptr);
 
 	do
 	{
-		loop_count++;
-		_delay_ms(500); /* Press time for keypad */
 		/* take elements of password using Keypad */
 		key=KEYPAD_getPressedKey();
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_KEY_TO_ECHO);
 
-		if ((key!=13)&&(loop_count<PASS_SIZE))
+		/* only digits are part of the password*/
+		if (KEYPAD_IS_DIGIT(key))
 		{
-			LCD_displayCharacter('*'); /* display * for every digit enter*/
-			*(passArray_ptr+loop_count)=key;
-		}
-		else if ((loop_count>=PASS_SIZE)&&(13!=key))
-		{
-			LCD_displayCharacter('*');/* display * for every digit enter*/
-			*(passArray_ptr)=13;
-			/* 13 :ASCCI code for enter key*/
-			/*if user enter password's length > saved password's length
-			 * store first digit by enter_key because it possible
-			 * so in comparing the result will be error
-			 */
-		}
-		else if ((loop_count<PASS_SIZE)&&(13==key))
-		{
-			*(passArray_ptr)=13;
-			/* 13 :ASCCI code for enter key*/
-			/*if user enter password's length < saved password's length
-			 * store first digit by enter_key because it possible
-			 * so in comparing the result will be error
-			 */
+			if (length<PASS_MAX_DIGITS)
+			{
+				LCD_FB_writeCharacter(1,length,'*'); /* display * for every digit enter*/
+				LCD_FB_render();
+				TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_KEY_TO_ECHO);
+				set_password_digit(passArray_ptr,length,key);
+				length++;
+			}
+			else
+			{
+				/*if user enter more than PASS_MAX_DIGITS digits
+				 * send an empty password , microcontroller2 rejects it by its length
+				 */
+				clear_password(passArray_ptr);
+			}
 		}
-
-	} while ((key!=13)&&(loop_count<16));
+		/* a shorter password is sent as it is , microcontroller2 rejects it by its length*/
+	} while (key!=KEYPAD_KEY_ENTER);
 }
 /*
  * Description: Function to interfacing with microcontroller2
  *                          if password is true : open door or change password
- *                                          else: wait 1 minute
+ *                                          else: enter it again till microcontroller2 locks out
  * [Args] :
  *         [in]   : pointer to array where I will store password in (global array)
  */
 void options(uint8 * passArray_ptr)
 {
 	uint8 option; /* hold + or - */
+	uint8 verdict; /*TRUE_PASSWORD , WRONG_PASSWORD or LOCKED_OUT from microcontroller2*/
 	/*show + or - in LCD and options */
 	option=show_options();
-	/*enter password to make option you choose*/
-	enter_pass(passArray_ptr);
-	/*sent it to microcontroller2 to check it*/
-	sent_password_using_uart(passArray_ptr);
-
-	if (UART_recieveByte()==TRUE_PASSWORD)
-	{
-		UART_sendByte(option);
-		if(option=='-')
-		{
-			/*set password at first time */
-			set_password(pass_array);
-			sent_password_using_uart(pass_array);
-		}
-		else
-		{
-			waiting_motor_on();
-			while(g_tick!=1055){}/*delay for 33 seconds*/
-			/*where 1055 is (((33(second))*(32(NUMBER_OF_OVERFLOWS_for_1_SECOND))-1)*/
-		}
-	}
-	else
+	do
 	{
 		/*enter password to make option you choose*/
 		enter_pass(passArray_ptr);
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_ENTER_TO_VERDICT);
+		/*sent it to microcontroller2 to check it*/
 		sent_password_using_uart(passArray_ptr);
-		if (UART_recieveByte()==TRUE_PASSWORD)
+
+		verdict=LINK_receiveByte();
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_ENTER_TO_VERDICT);
+		if (verdict==TRUE_PASSWORD)
 		{
-			UART_sendByte(option);
+			LINK_sendByte(option);
 			if(option=='-')
 			{
 				/*set password at first time */
@@ -459,80 +525,87 @@ void options(uint8 * passArray_ptr)
 			}
 			else
 			{
-				waiting_motor_on();
-				while(g_tick!=1055){}/*delay for 33 seconds*/
-				/*where 1055 is (((33(second))*(32(NUMBER_OF_OVERFLOWS_for_1_SECOND))-1)*/
+				/*follow the door cycle driven by microcontroller2 till the door is closed*/
+				show_door_status(STATUS_DOOR_CLOSED);
+				KEYPAD_flushEvents();
 			}
+			return;
 		}
-		else
+	} while (verdict!=LOCKED_OUT);
+	/*microcontroller2 locks out (its time grows with the failed attempts) , follow it till the lockout ends*/
+	show_door_status(STATUS_LOCKOUT_OFF);
+	/*clear LCD */
+	LCD_FB_clear();
+	LCD_FB_render();
+	/*keys pressed during the lockout are not taken*/
+	KEYPAD_flushEvents();
+}
+/*
+ * Description: Function to render the status events published by microcontroller2
+ * (door opening/open/closing/closed/obstructed , lockout on/off) on LCD as they arrive
+ * and the countdown events as a progress bar with the seconds left in the second line
+ * [Args] :
+ *         [in]   : status event that ends the sequence (STATUS_DOOR_CLOSED or STATUS_LOCKOUT_OFF)
+ */
+void show_door_status(uint8 last_status)
+{
+	uint8 message[3]; /*status event (and the seconds left of the countdown event)*/
+	uint8 status; /*to hold the received status event*/
+	uint16 remaining; /*seconds left from the countdown event*/
+	uint16 total=0; /*seconds of the whole sequence (first countdown event)*/
+	boolean obstructed=FALSE; /*obstruction shown till the door closes again*/
+	LCD_FB_clearRow(1);
+	do
+	{
+		LINK_receive(message,3);
+		status=message[0];
+		switch(status)
 		{
-			/*enter password to make option you choose*/
-			enter_pass(passArray_ptr);
-			sent_password_using_uart(passArray_ptr);
-			if (UART_recieveByte()==TRUE_PASSWORD)
+		case STATUS_COUNTDOWN:
+			remaining=(uint16)((message[1]<<8)|message[2]);
+			if(total==0)
 			{
-				UART_sendByte(option);
-				if(option=='-')
-				{
-					/*set password at first time */
-					set_password(pass_array);
-					sent_password_using_uart(pass_array);
-				}
-				else
-				{
-					waiting_motor_on();
-					while(g_tick!=1055){}/*delay for 33 seconds*/
-					/*where 1055 is (((33(second))*(32(NUMBER_OF_OVERFLOWS_for_1_SECOND))-1)*/
-				}
+				total=remaining;
 			}
-			else
+			LCD_PROGRESS_show(1,remaining,total);
+			LCD_FB_render();
+			break;
+		case STATUS_DOOR_OPENING:
+			if(!obstructed)
+			{
+				LCD_FB_writeLine_P(0,str_door_opening);
+				LCD_FB_render();
+			}
+			break;
+		case STATUS_DOOR_OPEN:
+			if(!obstructed)
 			{
-				wrong_password_on();
-				while(g_tick!=1919){}/*delay for 60 seconds*/
-				/*where 1055 is (((60(second))*(32(NUMBER_OF_OVERFLOWS_for_1_SECOND))-1)*/
-				/*clear LCD */
-				LCD_clearScreen();
+				LCD_FB_writeLine_P(0,str_door_open);
+				LCD_FB_render();
 			}
+			break;
+		case STATUS_DOOR_CLOSING:
+			obstructed=FALSE;
+			LCD_FB_writeLine_P(0,str_door_closing);
+			LCD_FB_render();
+			break;
+		case STATUS_LOCKOUT_ON:
+			LCD_FB_writeLine_P(0,str_lockout);
+			LCD_FB_render();
+			break;
+		case STATUS_DOOR_OBSTRUCTED:
+			LCD_FB_writeLine_P(0,str_door_obstructed);
+			LCD_FB_render();
+			/*the next countdown event gives the time of the new sequence*/
+			total=0;
+			obstructed=TRUE;
+			break;
+		default:
+			/* STATUS_DOOR_CLOSED , STATUS_LOCKOUT_OFF : nothing to show */
+			break;
 		}
-	}
-}
-/*
- * Description:Function for
- *           1) waiting till the buzzer be off (60 seconds)
- *              when user enter password three times wrong
- *              by set timer0 to calculate 60 seconds
- *           2) show error massage on LCD for 60 seconds
- *           3) set timer call (wrong_password_off) after counting 60 seconds
- */
-void wrong_password_on(void)
-{
-	/*clear LCD */
-	LCD_clearScreen();
-	/*use LCD to print message : "enter pass" */
-	LCD_displayString("Error");
-	/*initialize the timer0*/
-	s_timer_0_ConfigType conf={6,0,F_CPU_1024,NORMAL__MODE};
-	TIMER_0_init(&conf);
-	/*set call back for timer */
-	TIMER_0_setCallBack(wrong_password_off);
-}
-/*
- * Description: Function for
- *         1) waiting till the motor be off (33 seconds)
- *            when user enter password and choose option '+'
- *            by set timer0 to calculate 33 seconds
- *         2) set timer call (waiting_motor_off) after counting 60 seconds
- *         3)show on LCD "Door is opening"
- */
-void waiting_motor_on(void)
-{
-	/*clear LCD */
-	LCD_clearScreen();
-	/*use LCD to print message : "door is opening" */
-	LCD_displayString("Door is opening");
-	/*initialize the timer0*/
-	s_timer_0_ConfigType conf={0,250,F_CPU_1024,CTC_MODE};
-	TIMER_0_init(&conf);
-	/*set call back for timer */
-	TIMER_0_setCallBack(waiting_motor_off);
+	} while (status!=last_status);
+	/*remove the progress bar*/
+	LCD_FB_clearRow(1);
+	LCD_FB_render();
 }
@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ * Module: timebase
+ *
+ * File Name: timebase.h
+ *
+ * Description: Header file for the millisecond timebase (built on timer0 CTC mode)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* timer of the timebase
+ * TIMEBASE_TIMER0           : timer0 CTC mode
+ * TIMEBASE_TIMER1_COMPARE_B : compare B of timer1 (needs the timestamp driver running) , timer0 is left free
+ */
+#define TIMEBASE_TIMER0             0
+#define TIMEBASE_TIMER1_COMPARE_B   1
+#define TIMEBASE_SOURCE             TIMEBASE_TIMER0
+/* timer0 prescaler used by the timebase (F_CPU/64 : 125 counts per ms at 8MHZ) */
+#define TIMEBASE_PRESCALER        64UL
+/* maximum number of functions called from the timebase interrupt every 1 ms
+ * (mc2 adds 4 : buzzer , motor ramp , door and lockout timelines)
+ */
+#define TIMEBASE_MAX_HOOKS        6
+/* conversion of seconds to timebase units */
+#define TIMEBASE_SECONDS(s)       ((uint32)(s)*1000UL)
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the timebase
+ * 	1. start timer0 in CTC mode with one compare match every 1 ms
+ * 	2. the fraction of timer count per ms (F_CPU not multiple of 64000) is
+ * 	   accumulated and one extra count is added when it reaches a whole count
+ * 	   so long periods don't drift
+ * 	or (TIMEBASE_TIMER1_COMPARE_B) one timer1 compare B interrupt every 1 ms
+ * 	Note: global interrupts must be enabled (and TIMESTAMP_init called before for timer1)
+ */
+void TIMEBASE_init(void);
+/*
+ * Description: Function to return the number of ms since TIMEBASE_init (monotonic ,wraps after 49 days)
+ */
+uint32 TIMEBASE_now(void);
+/*
+ * Description: Function to return the number of ms passed since the (since) time stamp
+ * (correct across the wrap of TIMEBASE_now)
+ */
+uint32 TIMEBASE_elapsed(uint32 since);
+/*
+ * Description: Function to check if (period) ms are passed since the (since) time stamp
+ * [out] : TRUE or FALSE
+ */
+boolean TIMEBASE_hasElapsed(uint32 since,uint32 period);
+/*
+ * Description: Function to wait (period) ms
+ */
+void TIMEBASE_delayMs(uint32 period);
+/*
+ * Description: Function to add a function called from the timebase interrupt every 1 ms
+ * (must be short , it runs with interrupts disabled)
+ * [out] : TRUE if added or FALSE if TIMEBASE_MAX_HOOKS are already added
+ */
+boolean TIMEBASE_addHook(void(*a_ptr)(void));
+/*
+ * Description: Function to stop the program (interrupts disabled) on a timebase configuration error
+ * (a hook that isn't added : raise TIMEBASE_MAX_HOOKS)
+ */
+void TIMEBASE_halt(void);
+#endif /* TIMEBASE_H_ */
@@ -91,4 +91,8 @@ void TIMER_0_init(const s_timer_0_ConfigType * Config_Ptr);
  * 2-Disenable interrupt mask register
  */
 void TIMER_0_deInit(void);
+/*
+ * Description: Function to change the compare value of timer0 (CTC mode) while it is running
+ */
+void TIMER_0_setCompareValue(uint8 compare_value);
 #endif /* TIMER0_H_ */
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ * Module: timestamp
+ *
+ * File Name: timestamp.c
+ *
+ * Description: source file for the cycle timestamp driver (timer1 free running)
+ *              and the latency span records
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"timestamp.h"
+#include <avr/io.h> /* To use Timer1 Registers */
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* high 16 bits of the timestamp , counted by timer1 overflow */
+static volatile uint16 g_timestamp_high=0;
+/* start of every span */
+static uint32 g_span_start[TIMESTAMP_NUM_OF_SPANS];
+/* record of every span */
+static s_timestamp_SpanRecord g_span_records[TIMESTAMP_NUM_OF_SPANS];
+/*******************************************************************************
+ *                       Interrupt Service Routines                            *
+ *******************************************************************************/
+ISR(TIMER1_OVF_vect)
+{
+	g_timestamp_high++;
+}
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the timestamp driver
+ * 	1. timer1 normal mode with no prescaler (1 count = 1 CPU cycle)
+ * 	2. enable overflow interrupt to extend the count to 32 bits
+ */
+void TIMESTAMP_init(void)
+{
+	uint8 span;
+	for (span=0;span<TIMESTAMP_NUM_OF_SPANS;span++)
+	{
+		g_span_records[span].min=0xFFFFFFFF;
+		g_span_records[span].max=0;
+		g_span_records[span].sum=0;
+		g_span_records[span].count=0;
+	}
+	TCCR1A=0; /* normal mode , OC1A/OC1B disconnected */
+	TCNT1=0;
+	TCCR1B=(1<<CS10); /* clock with no prescaling */
+	TIMSK|=(1<<TOIE1); /* enable overflow interrupt */
+}
+/*
+ * Description: Function to return the 32 bit CPU cycle count (wraps after 536 seconds at 8MHZ)
+ */
+uint32 TIMESTAMP_now(void)
+{
+	uint16 low;
+	uint16 high;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		low=TCNT1;
+		high=g_timestamp_high;
+		/* overflow happened but its interrupt isn't served yet (interrupts are disabled) */
+		if ((TIFR&(1<<TOV1))&&(low<0x8000))
+		{
+			high++;
+		}
+	}
+	return ((uint32)high<<16)|low;
+}
+/*
+ * Description: Function to mark the start of a span
+ */
+void TIMESTAMP_spanBegin(e_timestamp_span span)
+{
+	g_span_start[span]=TIMESTAMP_now();
+}
+/*
+ * Description: Function to mark the end of a span and add it to its record
+ */
+void TIMESTAMP_spanEnd(e_timestamp_span span)
+{
+	uint32 cycles=TIMESTAMP_now()-g_span_start[span];
+	s_timestamp_SpanRecord * record=&g_span_records[span];
+
+	if (cycles<record->min)
+		record->min=cycles;
+	if (cycles>record->max)
+		record->max=cycles;
+	/* halve sum and count before any overflow , the average stays the same */
+	if ((record->sum+cycles<record->sum)||(record->count==0xFFFF))
+	{
+		record->sum>>=1;
+		record->count>>=1;
+	}
+	record->sum+=cycles;
+	record->count++;
+}
+/*
+ * Description: Function to return the record of a span
+ */
+const s_timestamp_SpanRecord * TIMESTAMP_getRecord(e_timestamp_span span)
+{
+	return &g_span_records[span];
+}
+/*
+ * Description: Function to return the average of a span in cycles (0 if not measured yet)
+ */
+uint32 TIMESTAMP_getAverage(e_timestamp_span span)
+{
+	if (g_span_records[span].count==0)
+		return 0;
+	return g_span_records[span].sum/g_span_records[span].count;
+}
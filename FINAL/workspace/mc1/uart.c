@@ -15,11 +15,38 @@
  *******************************************************************************/
 #include "uart.h"
 #include "avr/io.h" /* To use the UART Registers */
+#include <avr/pgmspace.h> /* To read the flash strings */
 #include "common_macros.h" /* To use the macros like SET_BIT */
+#if (UART_RX_BUFFER_ENABLE == TRUE)
+#include <avr/interrupt.h>
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* received bytes , written by the RX complete interrupt at head and read at tail */
+static volatile uint8 g_rxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_rxHead=0;
+static volatile uint8 g_rxTail=0;
+#endif
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
+#if (UART_RX_BUFFER_ENABLE == TRUE)
+/*
+ * Description :
+ * RX complete : keep the byte (dropped when the buffer is full)
+ */
+ISR(USART_RXC_vect)
+{
+	uint8 data=UDR;
+	uint8 next=(uint8)((g_rxHead+1)&(UART_RX_BUFFER_SIZE-1));
+	if(next!=g_rxTail)
+	{
+		g_rxBuffer[g_rxHead]=data;
+		g_rxHead=next;
+	}
+}
+#endif
 
 /*
  * Description :
@@ -46,6 +73,7 @@ void UART_init(const s_uart_ConfigType * Config_Ptr)
 	 ***********************************************************************/ 
 	/*
 	 * if you will use 9 bits mode you will use RXB8 & TXB8  used for 8-bit data mode
+	 * (the RX complete interrupt is enabled after the frame format when UART_RX_BUFFER_ENABLE)
 	 */
 
 	if (BIT_IS_SET(Config_Ptr->bits_size,2))
@@ -81,6 +109,11 @@ void UART_init(const s_uart_ConfigType * Config_Ptr)
 	/* First 8 bits from the BAUD_PRESCALE inside UBRRL and last 4 bits in UBRRH*/
 	UBRRH = ubrr_value>>8;
 	UBRRL = ubrr_value;
+#if (UART_RX_BUFFER_ENABLE == TRUE)
+	g_rxHead=0;
+	g_rxTail=0;
+	SET_BIT(UCSRB,RXCIE);
+#endif
 }
 
 /*
@@ -114,6 +147,14 @@ void UART_sendByte(const uint8 data)
  */
 uint8 UART_recieveByte(void)
 {
+#if (UART_RX_BUFFER_ENABLE == TRUE)
+	uint8 data;
+	/* wait till the RX complete interrupt adds a byte */
+	while(g_rxHead==g_rxTail){}
+	data=g_rxBuffer[g_rxTail];
+	g_rxTail=(uint8)((g_rxTail+1)&(UART_RX_BUFFER_SIZE-1));
+	return data;
+#else
 	/* RXC flag is set when the UART receive data so wait until this flag is set to one */
 	while(BIT_IS_CLEAR(UCSRA,RXC)){}
 
@@ -122,6 +163,7 @@ uint8 UART_recieveByte(void)
 	 * The RXC flag will be cleared after read the data
 	 */
 	return UDR;
+#endif
 }
 
 /*
@@ -146,6 +188,21 @@ void UART_sendString(const uint8 *Str)
 	}		
 	 *******************************************************************/
 }
+/*
+ * Description :
+ * Send the required string stored in flash (PROGMEM) through UART to the other UART device.
+ */
+void UART_sendString_P(const char *Str)
+{
+	uint8 data;
+
+	/* read the string byte by byte from flash and send it */
+	while((data = pgm_read_byte(Str)) != '\0')
+	{
+		UART_sendByte(data);
+		Str++;
+	}
+}
 
 /*
  * Description :
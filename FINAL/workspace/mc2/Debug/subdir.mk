@@ -4,32 +4,62 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../adc.c \
+../ascon.c \
 ../buzzer.c \
+../current_sense.c \
 ../dc_motor.c \
+../door_position.c \
 ../external_eeprom.c \
 ../gpio.c \
+../link.c \
+../lockout.c \
 ../mc_2.c \
+../pwm.c \
+../sha256.c \
+../timebase.c \
 ../timer0.c \
+../timestamp.c \
 ../twi.c \
 ../uart.c 
 
 OBJS += \
+./adc.o \
+./ascon.o \
 ./buzzer.o \
+./current_sense.o \
 ./dc_motor.o \
+./door_position.o \
 ./external_eeprom.o \
 ./gpio.o \
+./link.o \
+./lockout.o \
 ./mc_2.o \
+./pwm.o \
+./sha256.o \
+./timebase.o \
 ./timer0.o \
+./timestamp.o \
 ./twi.o \
 ./uart.o 
 
 C_DEPS += \
+./adc.d \
+./ascon.d \
 ./buzzer.d \
+./current_sense.d \
 ./dc_motor.d \
+./door_position.d \
 ./external_eeprom.d \
 ./gpio.d \
+./link.d \
+./lockout.d \
 ./mc_2.d \
+./pwm.d \
+./sha256.d \
+./timebase.d \
 ./timer0.d \
+./timestamp.d \
 ./twi.d \
 ./uart.d 
 
@@ -38,7 +68,7 @@ C_DEPS += \
 %.o: ../%.c subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -Wall -g2 -gstabs -O0 -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -Wall -g2 -gstabs -Os -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega16 -DF_CPU=8000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
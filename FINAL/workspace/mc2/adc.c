@@ -0,0 +1,67 @@
+/******************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.c
+ *
+ * Description: Source file for the ADC driver (auto triggered conversions with interrupt)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"adc.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* called with every conversion result */
+static void (*volatile g_callBackPtr)(uint16) = NULL_PTR;
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: conversion complete
+ */
+ISR(ADC_vect)
+{
+	if(g_callBackPtr != NULL_PTR)
+	{
+		(*g_callBackPtr)(ADC);
+	}
+}
+/*
+ *  Description : Function to initialize the ADC
+ * 	1. set the reference , channel and clock
+ * 	2. auto trigger from the required source with the conversion complete interrupt
+ * 	   (free running starts the first conversion)
+ */
+void ADC_init(const s_adc_ConfigType * Config_Ptr)
+{
+	/* REFS1:0 reference , ADLAR=0 right adjusted result , MUX4:0 single ended channel */
+	ADMUX=(uint8)((Config_Ptr->reference)<<REFS0)|((Config_Ptr->channel)&0x07);
+	/* ADTS2:0 in bits 7:5 of SFIOR */
+	SFIOR=(SFIOR&0x1F)|(uint8)((Config_Ptr->trigger)<<ADTS0);
+	ADCSRA=(1<<ADEN)|(1<<ADATE)|(1<<ADIF)|(1<<ADIE)|(Config_Ptr->prescaler);
+	if((Config_Ptr->trigger)==ADC_FREE_RUNNING)
+	{
+		ADCSRA|=(1<<ADSC);
+	}
+}
+/*
+ * Description: Function to set the call back function called with every result (in interrupt context)
+ */
+void ADC_setCallBack(void(*a_ptr)(uint16))
+{
+	g_callBackPtr = a_ptr;
+}
+/*
+ * Description: Function to disable the ADC
+ */
+void ADC_deInit(void)
+{
+	ADCSRA=0;
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ *
+ * Module: ADC
+ *
+ * File Name: adc.h
+ *
+ * Description: Header file for the ADC driver (auto triggered conversions with interrupt)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef ADC_H_
+#define ADC_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* maximum result of the 10 bit conversion */
+#define ADC_MAXIMUM_VALUE         1023
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*******************************************************************************
+ *  Enum name : e_adc_reference
+ *  Enum Description: voltage reference (REFS1:0)
+ */
+typedef enum
+{
+	ADC_AREF,ADC_AVCC,ADC_INTERNAL_2_56V=3
+}e_adc_reference;
+/*******************************************************************************
+ *  Enum name : e_adc_prescaler
+ *  Enum Description: ADC clock (ADPS2:0) , 50 to 200 KHZ for 10 bit resolution
+ */
+typedef enum
+{
+	ADC_F_CPU_2=1,ADC_F_CPU_4,ADC_F_CPU_8,ADC_F_CPU_16,ADC_F_CPU_32,ADC_F_CPU_64,ADC_F_CPU_128
+}e_adc_prescaler;
+/*******************************************************************************
+ *  Enum name : e_adc_trigger
+ *  Enum Description: auto trigger source of the conversions (ADTS2:0)
+ */
+typedef enum
+{
+	ADC_FREE_RUNNING,ADC_TRIGGER_ANALOG_COMPARATOR,ADC_TRIGGER_INT0,ADC_TRIGGER_TIMER0_COMPARE,
+	ADC_TRIGGER_TIMER0_OVERFLOW,ADC_TRIGGER_TIMER1_COMPARE_B,ADC_TRIGGER_TIMER1_OVERFLOW,ADC_TRIGGER_TIMER1_CAPTURE
+}e_adc_trigger;
+/*******************************************************************************
+ *  Structure name : s_adc_ConfigType
+ *  Structure Description:
+ *  this Structure is responsible for
+ *  1-voltage reference and ADC clock
+ *  2-trigger source of the conversions
+ *  3-input channel (0 to 7 : ADC0/PA0 to ADC7/PA7)
+ */
+typedef struct
+{
+	e_adc_reference reference;
+	e_adc_prescaler prescaler;
+	e_adc_trigger trigger;
+	uint8 channel;
+}s_adc_ConfigType;
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the ADC
+ * 	1. set the reference , channel and clock
+ * 	2. auto trigger from the required source with the conversion complete interrupt
+ * 	   (free running starts the first conversion)
+ */
+void ADC_init(const s_adc_ConfigType * Config_Ptr);
+/*
+ * Description: Function to set the call back function called with every result (in interrupt context)
+ */
+void ADC_setCallBack(void(*a_ptr)(uint16));
+/*
+ * Description: Function to disable the ADC
+ */
+void ADC_deInit(void);
+#endif /* ADC_H_ */
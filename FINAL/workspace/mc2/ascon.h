@@ -0,0 +1,48 @@
+/******************************************************************************
+ *
+ * Module: ascon
+ *
+ * File Name: ascon.h
+ *
+ * Description: Header file for the Ascon-128 authenticated encryption
+ *              (64 bit words kept as 32 bit halves for the 8 bit AVR)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef ASCON_H_
+#define ASCON_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+#define ASCON_KEY_SIZE            16
+#define ASCON_NONCE_SIZE          16
+#define ASCON_TAG_SIZE            16
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description: Function to encrypt (length) bytes and compute the tag
+ * [Args] :
+ *         [in]   : key , nonce (never used twice with the same key)
+ *         [in]   : associated data (authenticated , not encrypted) and its length
+ *         [in]   : plain text and its length
+ *         [out]  : cipher text (same length , may be the plain text buffer) and ASCON_TAG_SIZE bytes tag
+ */
+void ASCON_encrypt(const uint8 * key_ptr,const uint8 * nonce_ptr,const uint8 * ad_ptr,uint8 ad_length,
+		const uint8 * plain_ptr,uint8 * cipher_ptr,uint8 length,uint8 * tag_ptr);
+/*
+ * Description: Function to decrypt (length) bytes and check the first (tag_length) bytes of the tag
+ * [Args] :
+ *         [in]   : same key , nonce and associated data as the encryption
+ *         [in]   : cipher text and its length , tag and its length (up to ASCON_TAG_SIZE)
+ *         [out]  : plain text (may be the cipher text buffer) , cleared when the tag is wrong
+ *         [out]  : TRUE if the tag is right
+ */
+boolean ASCON_decrypt(const uint8 * key_ptr,const uint8 * nonce_ptr,const uint8 * ad_ptr,uint8 ad_length,
+		const uint8 * cipher_ptr,uint8 * plain_ptr,uint8 length,const uint8 * tag_ptr,uint8 tag_length);
+#endif /* ASCON_H_ */
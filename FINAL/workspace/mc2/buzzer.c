@@ -1,10 +1,11 @@
 /******************************************************************************
  *
- * Module: timer0
+ * Module: buzzer
  *
- * File Name: timer0.c
+ * File Name: buzzer.c
  *
- * Description: source file for the timer0 driver
+ * Description: source file for the buzzer driver
+ *              (tones by timer0 CTC toggle on OC0 and flash alert patterns)
  *
  * Author: mahmoud Mohamed
  *
@@ -14,43 +15,179 @@
  *                                includes                                 *
  *******************************************************************************/
 #include"buzzer.h"
+#include"timebase.h"
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
 
-
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* alert patterns */
+static const s_buzzer_Note g_buzzer_click[] PROGMEM=
+{
+	{4000,5},{0,BUZZER_PATTERN_END}
+};
+static const s_buzzer_Note g_buzzer_success[] PROGMEM=
+{
+	{1500,80},{0,30},{2000,80},{0,30},{2500,120},{0,BUZZER_PATTERN_END}
+};
+static const s_buzzer_Note g_buzzer_wrongCode[] PROGMEM=
+{
+	{400,250},{0,100},{400,250},{0,BUZZER_PATTERN_END}
+};
+static const s_buzzer_Note g_buzzer_lockout[] PROGMEM=
+{
+	{2500,300},{1800,300},{0,BUZZER_PATTERN_REPEAT}
+};
+/* patterns of e_buzzer_alert in its order */
+static const s_buzzer_Note * const g_buzzer_alerts[BUZZER_NUM_OF_ALERTS] PROGMEM=
+{
+	g_buzzer_click,g_buzzer_success,g_buzzer_wrongCode,g_buzzer_lockout
+};
+/* playing pattern (NULL_PTR : none) , index of its next note and ms left of the current note */
+static const s_buzzer_Note * volatile g_pattern=NULL_PTR;
+static volatile uint8 g_note=0;
+static volatile uint16 g_noteLeft=0;
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 /*
+ *  Description : Function to start the next note of the playing pattern
+ */
+static void BUZZER_nextNote(void)
+{
+	uint16 duration=pgm_read_word(&g_pattern[g_note].duration);
+	if(duration==BUZZER_PATTERN_REPEAT)
+	{
+		g_note=0;
+		duration=pgm_read_word(&g_pattern[0].duration);
+	}
+	if(duration==BUZZER_PATTERN_END)
+	{
+		BUZZER_tone(0);
+		g_pattern=NULL_PTR;
+		return;
+	}
+	BUZZER_tone(pgm_read_word(&g_pattern[g_note].frequency));
+	g_noteLeft=duration;
+	g_note++;
+}
+
+/*
+ *  Description : timebase hook (every 1 ms) , pattern sequencer
+ */
+static void BUZZER_sequence(void)
+{
+	if(g_pattern==NULL_PTR)
+	{
+		return;
+	}
+	g_noteLeft--;
+	if(g_noteLeft==0)
+	{
+		BUZZER_nextNote();
+	}
+}
 
 /*
  *  Description : Function to initialize the buzzer
- * 	with Set direction of the pin
+ * 	1. Set direction of the pin , timer0 stopped
+ * 	2. add the pattern sequencer to the timebase (call once after TIMEBASE_init)
  */
 void BUZZER_init(void)
 {
 	/*
-	 * Set pin as output for buzzer
+	 * Set pin as output for buzzer , low while OC0 is disconnected
 	 * */
-	GPIO_setupPinDirection(BUZZER_PORT, BUZZER_PIN, PIN_OUTPUT);
-	GPIO_writePin(BUZZER_PORT, BUZZER_PIN, OFF);
+	GPIO_PIN_LOW(BUZZER_PIN);
+	GPIO_PIN_OUTPUT(BUZZER_PIN);
+	TCCR0=0;
+	if(!TIMEBASE_addHook(BUZZER_sequence))
+	{
+		TIMEBASE_halt(); /* no free timebase hook */
+	}
 }
 
 /*
  *  Description : Function to on the buzzer
- * 	1. Set the pin
+ * 	tone of BUZZER_DEFAULT_FREQUENCY till BUZZER_off (stops the playing pattern)
  */
 void BUZZER_on(void)
 {
-	/* turn on buzzer*/
-	GPIO_writePin(BUZZER_PORT, BUZZER_PIN, ON);
+	g_pattern=NULL_PTR;
+	BUZZER_tone(BUZZER_DEFAULT_FREQUENCY);
 }
 
 
 /*
- *  Description : Function off the buzzer
+ *  Description : Function off the buzzer (stops the playing pattern)
  */
 void BUZZER_off(void)
 {
-	/* turn off buzzer*/
-	GPIO_writePin(BUZZER_PORT, BUZZER_PIN, OFF);
+	g_pattern=NULL_PTR;
+	BUZZER_tone(0);
+}
+
+/*
+ *  Description : Function to start a tone on OC0 (0 HZ stops it)
+ *  timer0 toggles the pin by hardware , no CPU time till the tone changes
+ */
+void BUZZER_tone(uint16 frequency)
+{
+	uint32 counts; /*timer counts of half a period*/
+	uint8 clock=1; /*CS02:0 , 1 : F_CPU*/
+	if(frequency==0)
+	{
+		/* timer stopped and OC0 disconnected , the pin goes back to its PORT value (low) */
+		TCCR0=0;
+		return;
+	}
+	counts=(F_CPU/2UL)/frequency;
+	/* smallest prescaler that fits half a period in 256 counts : F_CPU , /8 , /64 , /256 , /1024 */
+	while((counts>256)&&(clock<5))
+	{
+		counts>>=(clock<3)?3:2;
+		clock++;
+	}
+	if(counts>256)
+	{
+		counts=256;
+	}
+	TCCR0=0;
+	TCNT0=0;
+	OCR0=(uint8)(counts-1);
+	/* CTC mode (WGM01) , toggle OC0 on compare match (COM00) */
+	TCCR0=(1<<WGM01)|(1<<COM00)|clock;
+}
+
+/*
+ *  Description : Function to play a pattern (array of s_buzzer_Note in flash)
+ *  it replaces the playing pattern , the timebase plays the next notes
+ */
+void BUZZER_playPattern(const s_buzzer_Note * pattern_P)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_pattern=pattern_P;
+		g_note=0;
+		BUZZER_nextNote();
+	}
+}
+
+/*
+ *  Description : Function to play one of the alerts
+ */
+void BUZZER_playAlert(e_buzzer_alert alert)
+{
+	BUZZER_playPattern((const s_buzzer_Note *)pgm_read_ptr(&g_buzzer_alerts[alert]));
+}
+
+/*
+ *  Description : Function to return TRUE while a pattern is playing
+ */
+boolean BUZZER_isPlaying(void)
+{
+	return (g_pattern!=NULL_PTR);
 }
@@ -1,10 +1,11 @@
 /******************************************************************************
  *
- * Module: timer0
+ * Module: buzzer
  *
  * File Name: buzzer.h
  *
- * Description: Header file for the timer0 driver
+ * Description: Header file for the buzzer driver
+ *              (tones by timer0 CTC toggle on OC0 and flash alert patterns)
  *
  * Author: mahmoud Mohamed
  *
@@ -20,12 +21,43 @@
 /*******************************************************************************
  *                                 macros                                   *
  *******************************************************************************/
-/* buzzer HW Port and Pin Id */
-#define BUZZER_PORT PORTC_ID
-#define BUZZER_PIN  PIN7_ID
-/* define on and off */
-#define ON 1
-#define OFF 0
+/* buzzer HW Pin : OC0 of timer0 (compile time pin , see GPIO_PIN) , passive buzzer */
+#define BUZZER_PIN  GPIO_PIN(B,PIN3_ID)
+/* tone of BUZZER_on in HZ */
+#define BUZZER_DEFAULT_FREQUENCY  2000
+/* duration of the last note of a pattern : stop , or play the pattern again */
+#define BUZZER_PATTERN_END        0
+#define BUZZER_PATTERN_REPEAT     0xFFFF
+
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*******************************************************************************
+ *  Structure name : s_buzzer_Note
+ *  Structure Description:
+ *  one note of a pattern (patterns are arrays in flash)
+ *  1-frequency in HZ (0 : silence)
+ *  2-duration in ms (or BUZZER_PATTERN_END/BUZZER_PATTERN_REPEAT)
+ */
+typedef struct
+{
+	uint16 frequency;
+	uint16 duration;
+}s_buzzer_Note;
+/*******************************************************************************
+ *  Enum name : e_buzzer_alert
+ *  Enum Description:
+ *  alerts stored in flash
+ *  BUZZER_ALERT_CLICK      : short tick of a key
+ *  BUZZER_ALERT_SUCCESS    : rising three notes
+ *  BUZZER_ALERT_WRONG_CODE : two low beeps
+ *  BUZZER_ALERT_LOCKOUT    : two tone siren , repeated till BUZZER_off
+ */
+typedef enum
+{
+	BUZZER_ALERT_CLICK,BUZZER_ALERT_SUCCESS,BUZZER_ALERT_WRONG_CODE,BUZZER_ALERT_LOCKOUT,
+	BUZZER_NUM_OF_ALERTS
+}e_buzzer_alert;
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
@@ -33,21 +65,43 @@
 
 /*
  *  Description : Function to initialize the buzzer
- * 	with Set direction of the pin
+ * 	1. Set direction of the pin , timer0 stopped
+ * 	2. add the pattern sequencer to the timebase (call once after TIMEBASE_init)
  */
 void BUZZER_init(void);
 
 /*
  *  Description : Function to on the buzzer
- * 	1. Set the pin
+ * 	tone of BUZZER_DEFAULT_FREQUENCY till BUZZER_off (stops the playing pattern)
  */
 void BUZZER_on(void);
 
 
 /*
- *  Description : Function off the buzzer
+ *  Description : Function off the buzzer (stops the playing pattern)
  */
 void BUZZER_off(void);
 
+/*
+ *  Description : Function to start a tone on OC0 (0 HZ stops it)
+ *  timer0 toggles the pin by hardware , no CPU time till the tone changes
+ */
+void BUZZER_tone(uint16 frequency);
+
+/*
+ *  Description : Function to play a pattern (array of s_buzzer_Note in flash)
+ *  it replaces the playing pattern , the timebase plays the next notes
+ */
+void BUZZER_playPattern(const s_buzzer_Note * pattern_P);
+
+/*
+ *  Description : Function to play one of the alerts
+ */
+void BUZZER_playAlert(e_buzzer_alert alert);
+
+/*
+ *  Description : Function to return TRUE while a pattern is playing
+ */
+boolean BUZZER_isPlaying(void);
 
 #endif /* BUZZER_H_ */
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *
+ * Module: current sense
+ *
+ * File Name: current_sense.c
+ *
+ * Description: Source file for the motor current sensing (stall/obstruction detection)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"current_sense.h"
+#include"adc.h"
+#include <util/atomic.h>
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* called when a stall is detected */
+static void (*volatile g_callBackPtr)(void) = NULL_PTR;
+/* filtered current multiplied by 2^CURRENT_SENSE_FILTER_SHIFT (keeps the fraction of the filter) */
+static volatile uint16 g_filtered=0;
+/* TRUE while the motor is monitored */
+static volatile boolean g_armed=FALSE;
+/* samples left to ignore after arming */
+static volatile uint8 g_blanking=0;
+/* consecutive samples above the stall threshold */
+static uint8 g_stallSamples=0;
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: ADC call back (every sample)
+ * exponential moving average then stall check , same work for every sample
+ */
+static void CURRENT_SENSE_sample(uint16 sample)
+{
+	g_filtered=g_filtered-(g_filtered>>CURRENT_SENSE_FILTER_SHIFT)+sample;
+	if(!g_armed)
+	{
+		return;
+	}
+	if(g_blanking!=0)
+	{
+		g_blanking--;
+		return;
+	}
+	if((g_filtered>>CURRENT_SENSE_FILTER_SHIFT)>=CURRENT_SENSE_STALL_THRESHOLD)
+	{
+		g_stallSamples++;
+		if(g_stallSamples>=CURRENT_SENSE_STALL_SAMPLES)
+		{
+			g_armed=FALSE;
+			if(g_callBackPtr != NULL_PTR)
+			{
+				(*g_callBackPtr)();
+			}
+		}
+	}
+	else
+	{
+		g_stallSamples=0;
+	}
+}
+/*
+ *  Description : Function to initialize the current sensing
+ * 	1. ADC triggered by CURRENT_SENSE_TRIGGER (no CPU time to start the conversions)
+ * 	2. every result is filtered in the conversion complete interrupt (fixed time per sample)
+ * 	3. stall detection starts disarmed
+ */
+void CURRENT_SENSE_init(void)
+{
+	/* ADC clock 125 KHZ at 8MHZ : a conversion takes 104 us , much less than the 1 ms sample period */
+	s_adc_ConfigType conf={ADC_AVCC,ADC_F_CPU_64,CURRENT_SENSE_TRIGGER,CURRENT_SENSE_CHANNEL};
+	g_armed=FALSE;
+	g_filtered=0;
+	ADC_setCallBack(CURRENT_SENSE_sample);
+	ADC_init(&conf);
+}
+/*
+ * Description: Function to set the call back function called (in interrupt context) when a stall is detected
+ * the detection is disarmed before calling it
+ */
+void CURRENT_SENSE_setCallBack(void(*a_ptr)(void))
+{
+	g_callBackPtr = a_ptr;
+}
+/*
+ * Description: Function to start the stall detection (when the motor starts)
+ * the first CURRENT_SENSE_BLANKING_SAMPLES are not checked
+ */
+void CURRENT_SENSE_arm(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_blanking=CURRENT_SENSE_BLANKING_SAMPLES;
+		g_stallSamples=0;
+		g_armed=TRUE;
+	}
+}
+/*
+ * Description: Function to stop the stall detection (when the motor stops)
+ */
+void CURRENT_SENSE_disarm(void)
+{
+	g_armed=FALSE;
+}
+/*
+ * Description: Function to return the filtered current in ADC counts
+ */
+uint16 CURRENT_SENSE_getFiltered(void)
+{
+	uint16 filtered;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		filtered=g_filtered;
+	}
+	return filtered>>CURRENT_SENSE_FILTER_SHIFT;
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+ *
+ * Module: current sense
+ *
+ * File Name: current_sense.h
+ *
+ * Description: Header file for the motor current sensing (stall/obstruction detection)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef CURRENT_SENSE_H_
+#define CURRENT_SENSE_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* ADC channel of the shunt amplifier output (ADC0 = PA0) */
+#define CURRENT_SENSE_CHANNEL            0
+/* conversion started by every timebase compare match (timer1 compare B) : one sample every 1 ms */
+#define CURRENT_SENSE_TRIGGER            ADC_TRIGGER_TIMER1_COMPARE_B
+/* filter weight of a new sample 1/2^shift (time constant of about 8 samples) */
+#define CURRENT_SENSE_FILTER_SHIFT       3
+/* filtered current (ADC counts , depends on the shunt and the amplifier gain) of a stalled motor */
+#define CURRENT_SENSE_STALL_THRESHOLD    600
+/* consecutive samples above the threshold to detect a stall (noise and short peaks are ignored) */
+#define CURRENT_SENSE_STALL_SAMPLES      20
+/* samples ignored after arming (start current of the motor is higher than the stall threshold) */
+#define CURRENT_SENSE_BLANKING_SAMPLES   250
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the current sensing
+ * 	1. ADC triggered by CURRENT_SENSE_TRIGGER (no CPU time to start the conversions)
+ * 	2. every result is filtered in the conversion complete interrupt (fixed time per sample)
+ * 	3. stall detection starts disarmed
+ */
+void CURRENT_SENSE_init(void);
+/*
+ * Description: Function to set the call back function called (in interrupt context) when a stall is detected
+ * the detection is disarmed before calling it
+ */
+void CURRENT_SENSE_setCallBack(void(*a_ptr)(void));
+/*
+ * Description: Function to start the stall detection (when the motor starts)
+ * the first CURRENT_SENSE_BLANKING_SAMPLES are not checked
+ */
+void CURRENT_SENSE_arm(void);
+/*
+ * Description: Function to stop the stall detection (when the motor stops)
+ */
+void CURRENT_SENSE_disarm(void);
+/*
+ * Description: Function to return the filtered current in ADC counts
+ */
+uint16 CURRENT_SENSE_getFiltered(void);
+#endif /* CURRENT_SENSE_H_ */
@@ -12,6 +12,48 @@
 
 #include "dc_motor.h"
 #include "gpio.h"
+#include "pwm.h"
+#include "timebase.h"
+#include <avr/pgmspace.h> /* To read the ramp profiles */
+#include <util/delay.h> /* For the dead time */
+
+/* both motor pins in the motor port */
+#define DC_MOTOR_PORT       GPIO_PIN_PORT(DC_MOTOR_PIN1)
+#define DC_MOTOR_PINS_MASK  (GPIO_PIN_MASK(DC_MOTOR_PIN1) | GPIO_PIN_MASK(DC_MOTOR_PIN2))
+
+/* last state set on the motor pins */
+static DcMotor_State g_motor_state = DC_MOTOR_STOP;
+/* running ramp profile (NULL_PTR if none) and ms since its start */
+static const s_dcMotor_RampPoint * volatile g_motor_ramp = NULL_PTR;
+static uint16 g_motor_rampTime = 0;
+/* first point of the running ramp profile and the speed used for it */
+static const s_dcMotor_RampPoint * g_motor_rampFirst = NULL_PTR;
+static uint8 g_motor_rampFrom = 0;
+/* last speed (PWM duty) set */
+static volatile uint8 g_motor_speed = 0;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Function responsible for setting the motor pins of the required direction
+ */
+static void DcMotor_setDirection(DcMotor_State state);
+
+/*
+ * Function responsible for stepping the running ramp profile (timebase hook every 1 ms)
+ */
+static void DcMotor_rampStep(void);
+
+/*
+ * Function responsible for setting the speed PWM duty and keeping it as the current speed
+ */
+static void DcMotor_setDuty(uint8 speed);
+
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
 
 
 /*
@@ -19,45 +61,182 @@
  * Initialize the DC Motor by:
  * 1. Setup the direction of the two motor pins as output by send the request to GPIO driver.
  * 2. Stop the motor at the beginning
+ * 3. Start the speed PWM (timer2) and the ramp stepping from the timebase
  */
 void DcMotor_Init(void)
 {
 	/* Setup the two motor pins as output pins */
-	GPIO_setupPinDirection(DC_MOTOR_PORT1_ID,DC_MOTOR_PIN1_ID,PIN_OUTPUT);
-	GPIO_setupPinDirection(DC_MOTOR_PORT2_ID,DC_MOTOR_PIN2_ID,PIN_OUTPUT);
+	GPIO_PIN_OUTPUT(DC_MOTOR_PIN1);
+	GPIO_PIN_OUTPUT(DC_MOTOR_PIN2);
 
 	/* Motor is stopped at the beginning */
-	GPIO_writePin(DC_MOTOR_PORT1_ID,DC_MOTOR_PIN1_ID,LOGIC_LOW);
-	GPIO_writePin(DC_MOTOR_PORT2_ID,DC_MOTOR_PIN2_ID,LOGIC_LOW);
+	GPIO_PORT_WRITE_MASKED(DC_MOTOR_PORT,DC_MOTOR_PINS_MASK,0);
+	g_motor_state = DC_MOTOR_STOP;
+
+	PWM_Timer2_init();
+	if(!TIMEBASE_addHook(DcMotor_rampStep))
+	{
+		TIMEBASE_halt(); /* no free timebase hook */
+	}
 }
 
 /*
  * Description :
  * 1. Rotate  or Stop the motor according to the state input variable.
+ * 2. Full speed for CW/ACW (a running ramp is cancelled).
  */
 void DcMotor_Rotate(DcMotor_State state)
 {
+	g_motor_ramp = NULL_PTR;
+	DcMotor_setDirection(state);
+	DcMotor_setDuty((state == DC_MOTOR_STOP) ? 0 : PWM_MAX_DUTY);
+}
+
+/*
+ * Description :
+ * Change the motor speed (0 to 100 percent) without changing the direction
+ */
+void DcMotor_setSpeed(uint8 speed)
+{
+	DcMotor_setDuty(speed);
+}
+
+/*
+ * Description :
+ * Rotate the motor with the speed following the required ramp profile (array in flash)
+ */
+void DcMotor_rampRotate(DcMotor_State state,const s_dcMotor_RampPoint *profile)
+{
+	g_motor_ramp = NULL_PTR; /* the hook doesn't step while the ramp is changed */
+	g_motor_rampFrom = pgm_read_byte(&profile[0].speed);
+	DcMotor_setDuty(g_motor_rampFrom);
+	DcMotor_setDirection(state);
+	g_motor_rampTime = 0;
+	g_motor_rampFirst = profile;
+	g_motor_ramp = profile;
+}
+
+/*
+ * Description :
+ * Follow another ramp profile from now without changing the direction ,
+ * the profile starts from the current speed instead of the speed of its first point
+ */
+void DcMotor_rampChange(const s_dcMotor_RampPoint *profile)
+{
+	g_motor_ramp = NULL_PTR; /* the hook doesn't step while the ramp is changed */
+	g_motor_rampFrom = g_motor_speed;
+	g_motor_rampTime = 0;
+	g_motor_rampFirst = profile;
+	g_motor_ramp = profile;
+}
+
+/*
+ * Description :
+ * Return TRUE while a ramp profile is running
+ */
+boolean DcMotor_isRamping(void)
+{
+	return (g_motor_ramp != NULL_PTR);
+}
+
+/*
+ * Description :
+ * Set the motor pins , both pins change in one port write and a reversal stops the motor for the dead time first
+ */
+static void DcMotor_setDirection(DcMotor_State state)
+{
+	uint8 pins_value;
 	if(state == DC_MOTOR_CW)
 	{
 		/* Rotates the Motor CW */
-		GPIO_writePin(DC_MOTOR_PORT1_ID,DC_MOTOR_PIN1_ID,LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_PORT2_ID,DC_MOTOR_PIN2_ID,LOGIC_HIGH);
+		pins_value = GPIO_PIN_MASK(DC_MOTOR_PIN2);
 	}
 	else if(state == DC_MOTOR_ACW)
 	{
 		/* Rotates the Motor A-CW */
-		GPIO_writePin(DC_MOTOR_PORT1_ID,DC_MOTOR_PIN1_ID,LOGIC_HIGH);
-		GPIO_writePin(DC_MOTOR_PORT2_ID,DC_MOTOR_PIN2_ID,LOGIC_LOW);
+		pins_value = GPIO_PIN_MASK(DC_MOTOR_PIN1);
 	}
 	else if(state == DC_MOTOR_STOP)
 	{
 		/* Stop the Motor */
-		GPIO_writePin(DC_MOTOR_PORT1_ID,DC_MOTOR_PIN1_ID,LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_PORT2_ID,DC_MOTOR_PIN2_ID,LOGIC_LOW);
-
+		pins_value = 0;
 	}
 	else
 	{
 		/* Invalid Input State - Do Nothing */
+		return;
+	}
+
+	if((state != DC_MOTOR_STOP) && (g_motor_state != DC_MOTOR_STOP) && (state != g_motor_state))
+	{
+		/* reversal : both bridge inputs off before the other side is switched on */
+		GPIO_PORT_WRITE_MASKED(DC_MOTOR_PORT,DC_MOTOR_PINS_MASK,0);
+		_delay_us(DC_MOTOR_DEAD_TIME_US);
 	}
+	GPIO_PORT_WRITE_MASKED(DC_MOTOR_PORT,DC_MOTOR_PINS_MASK,pins_value);
+	g_motor_state = state;
+}
+
+/*
+ * Description :
+ * Every DC_MOTOR_RAMP_STEP_MS set the speed between the two profile points around the ramp time,
+ * at the end of the profile keep its last speed (stop the motor if it is 0)
+ */
+static void DcMotor_rampStep(void)
+{
+	static uint8 s_stepTicks = 0;
+	const s_dcMotor_RampPoint * point_ptr = g_motor_ramp;
+	uint16 time0,time1;
+	uint8 speed0,speed1;
+
+	if(point_ptr == NULL_PTR)
+	{
+		return;
+	}
+	g_motor_rampTime++;
+	s_stepTicks++;
+	if(s_stepTicks < DC_MOTOR_RAMP_STEP_MS)
+	{
+		return;
+	}
+	s_stepTicks = 0;
+
+	/* find the profile segment [point , next point] of the ramp time */
+	while(1)
+	{
+		time1 = pgm_read_word(&point_ptr[1].time_ms);
+		if((time1 == DC_MOTOR_RAMP_END) || (time1 > g_motor_rampTime))
+		{
+			break;
+		}
+		point_ptr++;
+	}
+	speed0 = (point_ptr == g_motor_rampFirst) ? g_motor_rampFrom : pgm_read_byte(&point_ptr[0].speed);
+	if(time1 == DC_MOTOR_RAMP_END)
+	{
+		/* end of the profile */
+		g_motor_ramp = NULL_PTR;
+		DcMotor_setDuty(speed0);
+		if(speed0 == 0)
+		{
+			DcMotor_setDirection(DC_MOTOR_STOP);
+		}
+		return;
+	}
+	time0 = pgm_read_word(&point_ptr[0].time_ms);
+	speed1 = pgm_read_byte(&point_ptr[1].speed);
+	/* linear speed between the two points */
+	DcMotor_setDuty((uint8)((sint16)speed0 +
+			(sint16)(((sint32)((sint16)speed1-(sint16)speed0)*(g_motor_rampTime-time0))/(time1-time0))));
+	g_motor_ramp = point_ptr; /* next step starts from this segment */
+}
+
+/*
+ * Description :
+ * Set the speed PWM duty and keep it as the current speed (start of a changed ramp)
+ */
+static void DcMotor_setDuty(uint8 speed)
+{
+	g_motor_speed = speed;
+	PWM_Timer2_setDuty(speed);
 }
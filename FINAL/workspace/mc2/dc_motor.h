@@ -18,12 +18,17 @@
 /*******************************************************************************
  *                                Definitions                                  *
  *******************************************************************************/
-/* The Ports and Pins IDs for the DC-Motor two pins */
-#define DC_MOTOR_PORT1_ID   PORTB_ID
-#define DC_MOTOR_PORT2_ID   PORTB_ID
+/* The DC-Motor two pins (compile time pins , see GPIO_PIN) , both on the same port so they change together */
+#define DC_MOTOR_PIN1       GPIO_PIN(B,PIN0_ID)
+#define DC_MOTOR_PIN2       GPIO_PIN(B,PIN1_ID)
 
-#define DC_MOTOR_PIN1_ID    PIN0_ID
-#define DC_MOTOR_PIN2_ID    PIN1_ID
+/* both bridge inputs low for this time before the motor reverses its direction */
+#define DC_MOTOR_DEAD_TIME_US   50
+
+/* speed (PWM duty on the bridge enable pin) is updated from the ramp profile every this ms */
+#define DC_MOTOR_RAMP_STEP_MS   10
+/* time of the last point of a ramp profile */
+#define DC_MOTOR_RAMP_END       0xFFFF
 
 /*******************************************************************************
  *                               Types Declaration                             *
@@ -33,6 +38,19 @@ typedef enum
 	DC_MOTOR_STOP,DC_MOTOR_CW,DC_MOTOR_ACW
 }DcMotor_State;
 
+/*******************************************************************************
+ *  Structure name : s_dcMotor_RampPoint
+ *  Structure Description:
+ *  one point of a speed ramp profile (profiles are arrays in flash ended by time DC_MOTOR_RAMP_END)
+ *  1-time in ms from the start of the ramp (increasing)
+ *  2-speed in percent at this time , the speed changes linearly between the points
+ */
+typedef struct
+{
+	uint16 time_ms;
+	uint8 speed;
+}s_dcMotor_RampPoint;
+
 /*******************************************************************************
  *                              Functions Prototypes                           *
  *******************************************************************************/
@@ -42,15 +60,43 @@ typedef enum
  * Initialize the DC Motor by:
  * 1. Setup the direction of the two motor pins as output by send the request to GPIO driver.
  * 2. Stop the motor at the beginning
+ * 3. Start the speed PWM (timer2) and the ramp stepping from the timebase (TIMEBASE_init must be called first)
  */
 void DcMotor_Init(void);
 
 /*
  * Description :
  * 1. Rotate  or Stop the motor according to the state input variable.
- *
+ * 2. Both pins change in one port write , a reversal stops the motor for DC_MOTOR_DEAD_TIME_US first.
+ * 3. Full speed for CW/ACW (a running ramp is cancelled).
  */
 void DcMotor_Rotate(DcMotor_State state);
 
+/*
+ * Description :
+ * Change the motor speed (0 to 100 percent) without changing the direction
+ */
+void DcMotor_setSpeed(uint8 speed);
+
+/*
+ * Description :
+ * Rotate the motor with the speed following the required ramp profile (array in flash , PROGMEM)
+ * the motor is stopped at the end of the profile if its last speed is 0
+ */
+void DcMotor_rampRotate(DcMotor_State state,const s_dcMotor_RampPoint *profile);
+
+/*
+ * Description :
+ * Follow another ramp profile from now without changing the direction (e.g. the slow phase near an end stop) ,
+ * the profile starts from the current speed instead of the speed of its first point
+ */
+void DcMotor_rampChange(const s_dcMotor_RampPoint *profile);
+
+/*
+ * Description :
+ * Return TRUE while a ramp profile is running
+ */
+boolean DcMotor_isRamping(void);
+
 
 #endif /* DC_MOTOR_H_ */
@@ -0,0 +1,157 @@
+/******************************************************************************
+ *
+ * Module: door position
+ *
+ * File Name: door_position.c
+ *
+ * Description: Source file for the door position driver
+ *              (open/closed limit switches and optional quadrature encoder)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"door_position.h"
+#include"gpio.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* called when an end stop is reached */
+static void (*volatile g_callBackPtr)(e_door_position_event) = NULL_PTR;
+#if (DOOR_POSITION_ENCODER_ENABLE == TRUE)
+/* encoder count , up while opening (motor clock wise) */
+static volatile sint16 g_count=0;
+#endif
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: Function to set the encoder count on an end stop and call the call back function
+ */
+static void DOOR_POSITION_reached(e_door_position_event event)
+{
+#if (DOOR_POSITION_ENCODER_ENABLE == TRUE)
+	/* the end stops correct the counts lost by the encoder */
+	g_count=(event==DOOR_POSITION_OPEN_REACHED)?DOOR_POSITION_OPEN_COUNT:0;
+#endif
+	if(g_callBackPtr != NULL_PTR)
+	{
+		(*g_callBackPtr)(event);
+	}
+}
+/*
+ * Description: open limit switch pressed
+ * (the level is read again so a spike on the line does not stop the door)
+ */
+ISR(INT1_vect)
+{
+	if(GPIO_PIN_READ(DOOR_POSITION_OPEN_SWITCH_PIN)==DOOR_POSITION_SWITCH_PRESSED)
+	{
+		DOOR_POSITION_reached(DOOR_POSITION_OPEN_REACHED);
+	}
+}
+/*
+ * Description: closed limit switch pressed
+ */
+ISR(INT2_vect)
+{
+	if(GPIO_PIN_READ(DOOR_POSITION_CLOSED_SWITCH_PIN)==DOOR_POSITION_SWITCH_PRESSED)
+	{
+		DOOR_POSITION_reached(DOOR_POSITION_CLOSED_REACHED);
+	}
+}
+#if (DOOR_POSITION_ENCODER_ENABLE == TRUE)
+/*
+ * Description: edge of encoder channel A , channel B gives the direction
+ * (two counts per encoder period) , the count passes by every value so the end stops are found by equality
+ */
+ISR(INT0_vect)
+{
+	if(GPIO_PIN_READ(DOOR_POSITION_ENCODER_A_PIN)!=GPIO_PIN_READ(DOOR_POSITION_ENCODER_B_PIN))
+	{
+		g_count++;
+		if(g_count==DOOR_POSITION_OPEN_COUNT)
+		{
+			DOOR_POSITION_reached(DOOR_POSITION_OPEN_REACHED);
+		}
+	}
+	else
+	{
+		g_count--;
+		if(g_count==0)
+		{
+			DOOR_POSITION_reached(DOOR_POSITION_CLOSED_REACHED);
+		}
+	}
+}
+#endif
+/*
+ *  Description : Function to initialize the door position driver
+ * 	1. switches and encoder pins as inputs with pull up
+ * 	2. INT1/INT2 on the falling edge of the switches , INT0 on any edge of encoder channel A
+ * 	3. encoder count starts at 0 (door closed) , it is set again by the end stops
+ */
+void DOOR_POSITION_init(void)
+{
+	GPIO_PIN_INPUT(DOOR_POSITION_OPEN_SWITCH_PIN);
+	GPIO_PIN_HIGH(DOOR_POSITION_OPEN_SWITCH_PIN);
+	GPIO_PIN_INPUT(DOOR_POSITION_CLOSED_SWITCH_PIN);
+	GPIO_PIN_HIGH(DOOR_POSITION_CLOSED_SWITCH_PIN);
+	/* INT1 falling edge (ISC11=1 , ISC10=0) , INT2 falling edge (ISC2=0) */
+	MCUCR=(MCUCR&~((1<<ISC11)|(1<<ISC10)))|(1<<ISC11);
+	MCUCSR&=~(1<<ISC2);
+#if (DOOR_POSITION_ENCODER_ENABLE == TRUE)
+	GPIO_PIN_INPUT(DOOR_POSITION_ENCODER_A_PIN);
+	GPIO_PIN_HIGH(DOOR_POSITION_ENCODER_A_PIN);
+	GPIO_PIN_INPUT(DOOR_POSITION_ENCODER_B_PIN);
+	GPIO_PIN_HIGH(DOOR_POSITION_ENCODER_B_PIN);
+	g_count=0;
+	/* INT0 any logical change (ISC01=0 , ISC00=1) */
+	MCUCR=(MCUCR&~((1<<ISC01)|(1<<ISC00)))|(1<<ISC00);
+	GIFR=(1<<INTF0);
+	GICR|=(1<<INT0);
+#endif
+	/* changing the sense control may set the flags , clear them before enabling */
+	GIFR=(1<<INTF1)|(1<<INTF2);
+	GICR|=(1<<INT1)|(1<<INT2);
+}
+/*
+ * Description: Function to set the call back function called (in interrupt context) when an end stop is reached
+ */
+void DOOR_POSITION_setCallBack(void(*a_ptr)(e_door_position_event))
+{
+	g_callBackPtr = a_ptr;
+}
+/*
+ * Description: Function to return TRUE if the door is on the open end stop
+ */
+boolean DOOR_POSITION_isOpen(void)
+{
+	return (GPIO_PIN_READ(DOOR_POSITION_OPEN_SWITCH_PIN)==DOOR_POSITION_SWITCH_PRESSED);
+}
+/*
+ * Description: Function to return TRUE if the door is on the closed end stop
+ */
+boolean DOOR_POSITION_isClosed(void)
+{
+	return (GPIO_PIN_READ(DOOR_POSITION_CLOSED_SWITCH_PIN)==DOOR_POSITION_SWITCH_PRESSED);
+}
+#if (DOOR_POSITION_ENCODER_ENABLE == TRUE)
+/*
+ * Description: Function to return the encoder count (0 closed , DOOR_POSITION_OPEN_COUNT open)
+ */
+sint16 DOOR_POSITION_getCount(void)
+{
+	sint16 count;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		count=g_count;
+	}
+	return count;
+}
+#endif
@@ -0,0 +1,78 @@
+/******************************************************************************
+ *
+ * Module: door position
+ *
+ * File Name: door_position.h
+ *
+ * Description: Header file for the door position driver
+ *              (open/closed limit switches and optional quadrature encoder)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef DOOR_POSITION_H_
+#define DOOR_POSITION_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* limit switches (compile time pins , see GPIO_PIN) , each one on an external interrupt pin */
+#define DOOR_POSITION_OPEN_SWITCH_PIN     GPIO_PIN(D,PIN3_ID) /*INT1*/
+#define DOOR_POSITION_CLOSED_SWITCH_PIN   GPIO_PIN(B,PIN2_ID) /*INT2*/
+/* switches connect the pin to ground (internal pull up) */
+#define DOOR_POSITION_SWITCH_PRESSED      LOGIC_LOW
+
+/* TRUE : quadrature encoder on the motor shaft , FALSE : limit switches only
+ * (the board and the Proteus project have no encoder : the door slows down by the measured travel time ,
+ *  set TRUE only on a board with the encoder wired to the pins below and DOOR_POSITION_OPEN_COUNT measured on it)
+ */
+#define DOOR_POSITION_ENCODER_ENABLE      FALSE
+/* encoder channel A on INT0 (both edges) , channel B read in its interrupt */
+#define DOOR_POSITION_ENCODER_A_PIN       GPIO_PIN(D,PIN2_ID) /*INT0*/
+#define DOOR_POSITION_ENCODER_B_PIN       GPIO_PIN(D,PIN4_ID)
+/* encoder counts from the closed end stop to the open end stop */
+#define DOOR_POSITION_OPEN_COUNT          1200
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*******************************************************************************
+ *  Enum name : e_door_position_event
+ *  Enum Description:
+ *  end stop reached (by its limit switch or by the encoder count)
+ */
+typedef enum
+{
+	DOOR_POSITION_OPEN_REACHED,DOOR_POSITION_CLOSED_REACHED
+}e_door_position_event;
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the door position driver
+ * 	1. switches and encoder pins as inputs with pull up
+ * 	2. INT1/INT2 on the falling edge of the switches , INT0 on any edge of encoder channel A
+ * 	3. encoder count starts at 0 (door closed) , it is set again by the end stops
+ */
+void DOOR_POSITION_init(void);
+/*
+ * Description: Function to set the call back function called (in interrupt context) when an end stop is reached
+ */
+void DOOR_POSITION_setCallBack(void(*a_ptr)(e_door_position_event));
+/*
+ * Description: Function to return TRUE if the door is on the open end stop
+ */
+boolean DOOR_POSITION_isOpen(void);
+/*
+ * Description: Function to return TRUE if the door is on the closed end stop
+ */
+boolean DOOR_POSITION_isClosed(void);
+#if (DOOR_POSITION_ENCODER_ENABLE == TRUE)
+/*
+ * Description: Function to return the encoder count (0 closed , DOOR_POSITION_OPEN_COUNT open)
+ */
+sint16 DOOR_POSITION_getCount(void);
+#endif
+#endif /* DOOR_POSITION_H_ */
@@ -80,3 +80,116 @@ uint8 EEPROM_readByte(uint16 u16addr, uint8 *u8data)
 
     return SUCCESS;
 }
+
+/* wait the end of the write cycle : the EEPROM doesn't acknowledge its address while writing */
+static uint8 EEPROM_waitReady(uint16 u16addr)
+{
+    uint16 polls;
+    for (polls = 0; polls < EEPROM_READY_POLLS; polls++)
+    {
+        TWI_start();
+        if (TWI_getStatus() != TWI_START)
+            return ERROR;
+        TWI_writeByte((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
+        if (TWI_getStatus() == TWI_MT_SLA_W_ACK)
+        {
+            TWI_stop();
+            return SUCCESS;
+        }
+        TWI_stop();
+    }
+    return ERROR;
+}
+
+uint8 EEPROM_writeBlock(uint16 u16addr, const uint8 *u8data, uint16 u16length)
+{
+    uint8 page_left;
+
+    while (u16length != 0)
+    {
+        /* bytes till the end of the page of u16addr */
+        page_left = (uint8)(EEPROM_PAGE_SIZE - (u16addr % EEPROM_PAGE_SIZE));
+
+        /* Send the Start Bit */
+        TWI_start();
+        if (TWI_getStatus() != TWI_START)
+            return ERROR;
+
+        /* Send the device address with A8 A9 A10 and R/W=0 (write) */
+        TWI_writeByte((uint8)(0xA0 | ((u16addr & 0x0700)>>7)));
+        if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+            return ERROR;
+
+        /* Send the required memory location address */
+        TWI_writeByte((uint8)(u16addr));
+        if (TWI_getStatus() != TWI_MT_DATA_ACK)
+            return ERROR;
+
+        /* write the bytes of this page */
+        while ((u16length != 0) && (page_left != 0))
+        {
+            TWI_writeByte(*u8data);
+            if (TWI_getStatus() != TWI_MT_DATA_ACK)
+                return ERROR;
+            u8data++;
+            u16addr++;
+            u16length--;
+            page_left--;
+        }
+
+        /* Send the Stop Bit , the EEPROM starts its write cycle */
+        TWI_stop();
+        if (EEPROM_waitReady(u16addr - 1) == ERROR)
+            return ERROR;
+    }
+    return SUCCESS;
+}
+
+uint8 EEPROM_readBlock(uint16 u16addr, uint8 *u8data, uint16 u16length)
+{
+    if (u16length == 0)
+        return SUCCESS;
+
+	/* Send the Start Bit */
+    TWI_start();
+    if (TWI_getStatus() != TWI_START)
+        return ERROR;
+
+    /* Send the device address with A8 A9 A10 and R/W=0 (write) */
+    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7)));
+    if (TWI_getStatus() != TWI_MT_SLA_W_ACK)
+        return ERROR;
+
+    /* Send the required memory location address */
+    TWI_writeByte((uint8)(u16addr));
+    if (TWI_getStatus() != TWI_MT_DATA_ACK)
+        return ERROR;
+
+    /* Send the Repeated Start Bit */
+    TWI_start();
+    if (TWI_getStatus() != TWI_REP_START)
+        return ERROR;
+
+    /* Send the device address with A8 A9 A10 and R/W=1 (Read) */
+    TWI_writeByte((uint8)((0xA0) | ((u16addr & 0x0700)>>7) | 1));
+    if (TWI_getStatus() != TWI_MT_SLA_R_ACK)
+        return ERROR;
+
+    /* the EEPROM sends the next bytes while they are acknowledged , NACK on the last one */
+    while (u16length > 1)
+    {
+        *u8data = TWI_readByteWithACK();
+        if (TWI_getStatus() != TWI_MR_DATA_ACK)
+            return ERROR;
+        u8data++;
+        u16length--;
+    }
+    *u8data = TWI_readByteWithNACK();
+    if (TWI_getStatus() != TWI_MR_DATA_NACK)
+        return ERROR;
+
+    /* Send the Stop Bit */
+    TWI_stop();
+
+    return SUCCESS;
+}
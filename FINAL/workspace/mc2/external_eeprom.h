@@ -22,11 +22,20 @@
 #define ERROR 0
 #define SUCCESS 1
 
+/* bytes of one write page (24C16) , a block write is split at the page boundaries */
+#define EEPROM_PAGE_SIZE 16
+/* device address polls while the EEPROM finishes its write cycle (about 10 ms at 400 KHZ) */
+#define EEPROM_READY_POLLS 1000
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
 uint8 EEPROM_writeByte(uint16 u16addr,uint8 u8data);
 uint8 EEPROM_readByte(uint16 u16addr,uint8 *u8data);
+/* write u16length bytes , one page write at a time , returns when the last write cycle ends */
+uint8 EEPROM_writeBlock(uint16 u16addr,const uint8 *u8data,uint16 u16length);
+/* read u16length bytes in one sequential read */
+uint8 EEPROM_readBlock(uint16 u16addr,uint8 *u8data,uint16 u16length);
  
 #endif /* EXTERNAL_EEPROM_H_ */
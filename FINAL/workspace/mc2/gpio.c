@@ -329,3 +329,40 @@ uint8 GPIO_readPort(uint8 port_num)
 
 	return value;
 }
+
+/*
+ * Description :
+ * Write the value bits on the mask pins of the required port in one interrupt safe read-modify-write.
+ * The pins out of the mask are not changed.
+ * If the input port number is not correct, The function will not handle the request.
+ */
+void GPIO_writeMasked(uint8 port_num, uint8 mask, uint8 value)
+{
+	/*
+	 * Check if the input number is greater than NUM_OF_PORTS value.
+	 * In this case the input is not valid port number
+	 */
+	if(port_num >= NUM_OF_PORTS)
+	{
+		/* Do Nothing */
+	}
+	else
+	{
+		/* Write the masked pins value as required */
+		switch(port_num)
+		{
+		case PORTA_ID:
+			GPIO_PORT_WRITE_MASKED(A,mask,value);
+			break;
+		case PORTB_ID:
+			GPIO_PORT_WRITE_MASKED(B,mask,value);
+			break;
+		case PORTC_ID:
+			GPIO_PORT_WRITE_MASKED(C,mask,value);
+			break;
+		case PORTD_ID:
+			GPIO_PORT_WRITE_MASKED(D,mask,value);
+			break;
+		}
+	}
+}
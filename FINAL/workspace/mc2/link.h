@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Module: link
+ *
+ * File Name: link.h
+ *
+ * Description: Header file for the authenticated and encrypted link between the two microcontrollers
+ *              (Ascon-128 frames over the UART)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef LINK_H_
+#define LINK_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* node of this microcontroller , each sender has its own nonces with the shared key */
+#define LINK_NODE_MC1             1
+#define LINK_NODE_MC2             2
+#define LINK_NODE                 LINK_NODE_MC2
+/* frame : LINK_SOF , length , counter , cipher text (length bytes) , tag
+ * counter : boot counter (internal EEPROM) and message counter of the sender , part of the nonce
+ */
+#define LINK_SOF                  0xA5
+#define LINK_MAX_PAYLOAD          16
+#define LINK_COUNTER_SIZE         8
+/* first bytes of the Ascon tag sent in the frame */
+#define LINK_TAG_SIZE             8
+/* transaction challenge : boot counter , challenge counter , timer jitter
+ * frames of a transaction are authenticated with its challenge as associated data
+ */
+#define LINK_CHALLENGE_SIZE       8
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the link (after UART_init)
+ * 	1. read the key from the last ASCON_KEY_SIZE bytes of the internal EEPROM
+ * 	   (programmed per door , the same key in both microcontrollers : see link_key.py)
+ * 	2. increment the boot counter in the internal EEPROM (nonces are never used again after a reset)
+ * [Args] :
+ *         [out]  : FALSE if no key is programmed (erased EEPROM) , the link must not be used
+ */
+boolean LINK_init(void);
+/*
+ * Description: Function to encrypt and send one message of (length) bytes (up to LINK_MAX_PAYLOAD)
+ */
+void LINK_send(const uint8 * payload_ptr,uint8 length);
+/*
+ * Description: Function to wait for the next authentic message
+ * frames with a wrong tag or an old counter (replayed) are dropped
+ * [Args] :
+ *         [out]  : message (up to max_length bytes are copied)
+ *         [out]  : length of the message
+ */
+uint8 LINK_receive(uint8 * payload_ptr,uint8 max_length);
+/*
+ * Description: Function to send a one byte message
+ */
+void LINK_sendByte(uint8 data);
+/*
+ * Description: Function to make a fresh challenge for a transaction (never repeated , even after a reset)
+ * [Args] :
+ *         [out]  : challenge (LINK_CHALLENGE_SIZE bytes)
+ */
+void LINK_newChallenge(uint8 * challenge_ptr);
+/*
+ * Description: Function to bind the next frames (sent and received) to a transaction challenge
+ * a frame recorded in another transaction fails authentication , NULL_PTR ends the binding
+ */
+void LINK_bind(const uint8 * challenge_ptr);
+/*
+ * Description: Function to wait for the next authentic message and return its first byte
+ */
+uint8 LINK_receiveByte(void);
+#endif /* LINK_H_ */
@@ -0,0 +1,205 @@
+/******************************************************************************
+ *
+ * Module: lockout
+ *
+ * File Name: lockout.c
+ *
+ * Description: Source file for the password attempts lockout
+ *              (failed attempts kept in the internal EEPROM , lockout time doubles with the failures)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"lockout.h"
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* record : sequence number then value , the newest record is the last one of the
+ * sequence (the next record doesn't have the next sequence number)
+ */
+#define LOCKOUT_SEQUENCE          0
+#define LOCKOUT_VALUE             1
+#define LOCKOUT_RECORD_SIZE       2
+/* value : failures counter (bits 0..6) and the lockout served flag (bit 7) , 0xFF is an erased record */
+#define LOCKOUT_FAILURES_MASK     0x7F
+#define LOCKOUT_SERVED            0x80
+#define LOCKOUT_ERASED            0xFF
+#define LOCKOUT_MAX_FAILURES      0x7E
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+static uint8 EEMEM g_lockout_ringEeprom[LOCKOUT_RING_SIZE][LOCKOUT_RECORD_SIZE];
+/* newest record */
+static uint8 g_lockout_index=0;
+static uint8 g_lockout_sequence=0;
+/* consecutive failed attempts and lockout served flag (copy of the newest record) */
+static uint8 g_lockout_failures=0;
+static boolean g_lockout_served=TRUE;
+/* current lockout : start time stamp (ms) and time , ended by LOCKOUT_poll (timebase hook)
+ * then saved as served by LOCKOUT_saveServed
+ */
+static volatile boolean g_lockout_active=FALSE;
+static volatile boolean g_lockout_ended=FALSE;
+static volatile uint32 g_lockout_start=0;
+static volatile uint32 g_lockout_time=0;
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: Function to write the failures counter and the served flag in the next record
+ * (value first then sequence , a power off in between leaves the old newest record)
+ */
+static void LOCKOUT_save(void)
+{
+	g_lockout_index=(uint8)((g_lockout_index+1)%LOCKOUT_RING_SIZE);
+	g_lockout_sequence++;
+	eeprom_update_byte(&g_lockout_ringEeprom[g_lockout_index][LOCKOUT_VALUE],
+			(uint8)(g_lockout_failures|(g_lockout_served?LOCKOUT_SERVED:0)));
+	eeprom_update_byte(&g_lockout_ringEeprom[g_lockout_index][LOCKOUT_SEQUENCE],g_lockout_sequence);
+}
+/*
+ * Description: Function to start the lockout of the current failures counter
+ * time : LOCKOUT_BASE_TIME_MS doubled by every previous lockout (without a right password between)
+ */
+static void LOCKOUT_start(void)
+{
+	uint8 shift=(uint8)((g_lockout_failures/LOCKOUT_ATTEMPTS)-1);
+	if(shift>LOCKOUT_MAX_SHIFT)
+	{
+		shift=LOCKOUT_MAX_SHIFT;
+	}
+	g_lockout_time=LOCKOUT_BASE_TIME_MS<<shift;
+	g_lockout_start=TIMEBASE_now();
+	/*last : the timebase hook reads the time only when the lockout is active*/
+	g_lockout_active=TRUE;
+}
+/*
+ *  Description : Function to initialize the lockout (after TIMEBASE_init)
+ * 	1. find the newest record of the failures counter in the internal EEPROM
+ * 	2. a lockout not served before the power off starts again in full
+ * 	   (the time the power was off is not known)
+ */
+void LOCKOUT_init(void)
+{
+	uint8 index;
+	uint8 next;
+	uint8 value;
+	/* the newest record is where the sequence breaks */
+	for(index=0;index<LOCKOUT_RING_SIZE;index++)
+	{
+		next=(uint8)((index+1)%LOCKOUT_RING_SIZE);
+		if(eeprom_read_byte(&g_lockout_ringEeprom[next][LOCKOUT_SEQUENCE])!=
+				(uint8)(eeprom_read_byte(&g_lockout_ringEeprom[index][LOCKOUT_SEQUENCE])+1))
+		{
+			break;
+		}
+	}
+	g_lockout_index=(uint8)(index%LOCKOUT_RING_SIZE);
+	g_lockout_sequence=eeprom_read_byte(&g_lockout_ringEeprom[g_lockout_index][LOCKOUT_SEQUENCE]);
+	value=eeprom_read_byte(&g_lockout_ringEeprom[g_lockout_index][LOCKOUT_VALUE]);
+	if(value==LOCKOUT_ERASED)
+	{
+		value=LOCKOUT_SERVED;
+	}
+	g_lockout_failures=value&LOCKOUT_FAILURES_MASK;
+	g_lockout_served=(value&LOCKOUT_SERVED)?TRUE:FALSE;
+	g_lockout_active=FALSE;
+	if((!g_lockout_served)&&(g_lockout_failures!=0)&&((g_lockout_failures%LOCKOUT_ATTEMPTS)==0))
+	{
+		LOCKOUT_start();
+	}
+}
+/*
+ * Description: Function to count a password attempt as failed before it is checked
+ * (written to the EEPROM , a power off after the verdict doesn't lose it)
+ */
+void LOCKOUT_attempt(void)
+{
+	if(g_lockout_failures<LOCKOUT_MAX_FAILURES)
+	{
+		g_lockout_failures++;
+	}
+	g_lockout_served=FALSE;
+	LOCKOUT_save();
+}
+/*
+ * Description: Function to end the attempt counted by LOCKOUT_attempt
+ * TRUE : right password (the failures counter is cleared)
+ * FALSE: wrong password (the lockout starts after LOCKOUT_ATTEMPTS failures)
+ */
+void LOCKOUT_result(boolean passed)
+{
+	if(passed)
+	{
+		g_lockout_failures=0;
+		g_lockout_served=TRUE;
+		LOCKOUT_save();
+	}
+	else if((g_lockout_failures%LOCKOUT_ATTEMPTS)==0)
+	{
+		LOCKOUT_start();
+	}
+}
+/*
+ * Description: Function to end the lockout when its time is over (timebase hook , no EEPROM access)
+ */
+boolean LOCKOUT_poll(void)
+{
+	if(g_lockout_active&&TIMEBASE_hasElapsed(g_lockout_start,g_lockout_time))
+	{
+		g_lockout_active=FALSE;
+		g_lockout_ended=TRUE;
+	}
+	return g_lockout_active;
+}
+/*
+ * Description: Function to check the lockout out of interrupts (no EEPROM access)
+ */
+boolean LOCKOUT_isActive(void)
+{
+	boolean active;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		/*the timebase hook may poll too*/
+		active=LOCKOUT_poll();
+	}
+	return active;
+}
+/*
+ * Description: Function to save an ended lockout as served in the EEPROM (one record write , about 17 ms)
+ * it doesn't start again after a power off , nothing is written if no lockout ended since the last call
+ */
+void LOCKOUT_saveServed(void)
+{
+	boolean ended;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		/*the end is taken once*/
+		LOCKOUT_poll();
+		ended=g_lockout_ended;
+		g_lockout_ended=FALSE;
+	}
+	if(ended)
+	{
+		g_lockout_served=TRUE;
+		LOCKOUT_save();
+	}
+}
+/*
+ * Description: Function to get the time left of the lockout in ms (0 if not active)
+ */
+uint32 LOCKOUT_remaining(void)
+{
+	uint32 elapsed;
+	if(!g_lockout_active)
+	{
+		return 0;
+	}
+	elapsed=TIMEBASE_elapsed(g_lockout_start);
+	return (elapsed<g_lockout_time)?(g_lockout_time-elapsed):0;
+}
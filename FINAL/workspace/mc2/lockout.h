@@ -0,0 +1,75 @@
+/******************************************************************************
+ *
+ * Module: lockout
+ *
+ * File Name: lockout.h
+ *
+ * Description: Header file for the password attempts lockout
+ *              (failed attempts kept in the internal EEPROM , lockout time doubles with the failures)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef LOCKOUT_H_
+#define LOCKOUT_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+#include"timebase.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* consecutive wrong passwords before each lockout */
+#define LOCKOUT_ATTEMPTS          3
+/* first lockout time , doubled by every next lockout up to LOCKOUT_MAX_SHIFT times (32 minutes) */
+#define LOCKOUT_BASE_TIME_MS      TIMEBASE_SECONDS(60)
+#define LOCKOUT_MAX_SHIFT         5
+/* records of the failures counter in the internal EEPROM , every write goes to the next record
+ * (each EEPROM cell is written once per LOCKOUT_RING_SIZE attempts)
+ */
+#define LOCKOUT_RING_SIZE         16
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the lockout
+ * 	1. find the newest record of the failures counter in the internal EEPROM
+ * 	2. a lockout not served before the power off starts again in full
+ * 	   (the time the power was off is not known)
+ */
+void LOCKOUT_init(void);
+/*
+ * Description: Function to count a password attempt as failed before it is checked
+ * (written to the EEPROM , a power off after the verdict doesn't lose it)
+ */
+void LOCKOUT_attempt(void);
+/*
+ * Description: Function to end the attempt counted by LOCKOUT_attempt
+ * [Args] :
+ *         [in]   : TRUE : right password (the failures counter is cleared , one record write)
+ *                  FALSE: wrong password (the lockout starts after LOCKOUT_ATTEMPTS failures , no EEPROM write)
+ */
+void LOCKOUT_result(boolean passed);
+/*
+ * Description: Function to end the lockout when its time is over (timebase hook , no EEPROM access)
+ * [Args] :
+ *         [out]  : TRUE while the lockout is active
+ */
+boolean LOCKOUT_poll(void);
+/*
+ * Description: Function to check the lockout out of interrupts (no EEPROM access)
+ * [Args] :
+ *         [out]  : TRUE while password attempts are not accepted
+ */
+boolean LOCKOUT_isActive(void);
+/*
+ * Description: Function to save an ended lockout as served in the EEPROM (one record write , about 17 ms)
+ * it doesn't start again after a power off , nothing is written if no lockout ended since the last call
+ */
+void LOCKOUT_saveServed(void);
+/*
+ * Description: Function to get the time left of the lockout in ms (0 if not active)
+ */
+uint32 LOCKOUT_remaining(void);
+#endif /* LOCKOUT_H_ */
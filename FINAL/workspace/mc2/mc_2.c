@@ -12,44 +12,89 @@
 /*******************************************************************************
  *                                includes                                 *
  *******************************************************************************/
-/* define frequency of processor to 8MGZ */
+/* define frequency of processor to 8MGZ (normally given to all files by the build -DF_CPU) */
+#ifndef F_CPU
 #define F_CPU 8000000UL
-#include <util/delay.h> /*to use (_delay_ms(value)) */
-#include"timer0.h"
+#endif
+#include"timebase.h"
+#include"timestamp.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <string.h>
 #include "buzzer.h"
 #include"uart.h"
+#include"link.h"
 #include"dc_motor.h"
+#include"door_position.h"
+#include"current_sense.h"
+#include"lockout.h"
 #include"std_types.h"
 #include "external_eeprom.h"
 #include "twi.h"
+#include "sha256.h"
 /*******************************************************************************
  *                                macros                                *
  *******************************************************************************/
 #define MC1_READY      0x20
 #define MC2_READY      0x10
-/*/addrees of first element of password will store in 0x0014 in EEPROM*/
+/* start up query of microcontroller1 : is a password stored (answered before the transaction handshake) */
+#define MC1_PASS_QUERY 0x21
+#define PASS_STORED    0x11
+#define PASS_NOT_STORED 0x12
+/*/addrees of the password record in 0x0014 in EEPROM*/
 #define address_in_eeprom 0x0014
-#define PASS_SIZE             5  /*refer to size of password*/
-/*for one second :need 64 overflow (interrupt)*/
+/* password : 4 to 16 digits in packed BCD (first digit in the high nibble of the first byte) ,
+ * the nibbles after the last digit are PASS_NO_DIGIT
+ */
+#define PASS_MIN_DIGITS       4
+#define PASS_MAX_DIGITS       16
+#define PASS_SIZE             (PASS_MAX_DIGITS/2)  /*refer to size of password*/
+#define PASS_NO_DIGIT         0x0F
+/* password record in EEPROM : random salt , number of digits then SHA-256 of (salt , password) ,
+ * the password itself is not stored
+ */
+#define SALT_SIZE             8
+#define PASS_LENGTH_OFFSET    SALT_SIZE
+#define PASS_DIGEST_OFFSET    (SALT_SIZE+1)
+#define PASS_RECORD_SIZE      (PASS_DIGEST_OFFSET+SHA256_DIGEST_SIZE)
+/* the verdict is sent this time after the last password byte , right or wrong
+ * (must stay above the maximum of TIMESTAMP_SPAN_VERIFY , the worst case is a checked password :
+ *  the failed attempt record is two internal EEPROM byte writes (8.5 ms each , 17 ms if counted in full) ,
+ *  about 8 ms of hashing and about 2 ms of reading the record from the external EEPROM : 27 ms ,
+ *  all other internal EEPROM writes are after the verdict or before the password is received)
+ */
+#define VERIFY_TIME_MS        40
+#define VERIFY_TIME_CYCLES    ((uint32)VERIFY_TIME_MS*(F_CPU/1000UL))
 #define WRONG_PASSWORD 0
 #define TRUE_PASSWORD  1
-/*for one second :need 64 overflow (interrupt)*/
-/* why 32 : (1024/(8*10^6))*250*(10^3)
- * where  1024   :  prescaler
- *        8*10^6 :  F_cpu
- *        10^3   :  one second
- *        250    : number of interrupts
- */
-#define NUMBER_OF_OVERFLOWS_for_1_SECOND 32
+#define LOCKED_OUT     2 /*wrong password or attempt in a lockout , the lockout status events follow*/
+/* status events published to microcontroller1 when the motor or lockout state changes */
+#define STATUS_DOOR_OPENING   0x30
+#define STATUS_DOOR_OPEN      0x31
+#define STATUS_DOOR_CLOSING   0x32
+#define STATUS_DOOR_CLOSED    0x33
+#define STATUS_LOCKOUT_ON     0x34
+#define STATUS_LOCKOUT_OFF    0x35
+/* countdown event : followed by two bytes (high byte first) of the seconds left till the door is closed or the lockout ends */
+#define STATUS_COUNTDOWN      0x36
+/* obstruction event : the motor stalled , a closing door is opened again and an opening door stops */
+#define STATUS_DOOR_OBSTRUCTED 0x37
+/* door timeline : each travel ends on its end stop (door_position) or after the timeout */
+#define DOOR_TRAVEL_TIME_MS    TIMEBASE_SECONDS(15) /*timeout of the motor opening or closing the door*/
+#define DOOR_HOLD_TIME_MS      TIMEBASE_SECONDS(3)  /*door held open from the open end stop*/
+/* the door slows down this many encoder counts before the end stop it moves to
+ * (without the encoder : this time before the end of the last measured travel)
+ */
+#define DOOR_SLOW_COUNT        200
+#define DOOR_SLOW_TIME_MS      1500
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 /*
  * Description: Function for initialize  all drivers
  *  1)Enable global interrupts
- *  2)dc_motor
- *  3)UART
+ *  2)dc_motor (with its speed PWM and ramps) , door position and motor current sensing
+ *  3)UART and link
  */
 void init_microcontroller(void);
 /*
@@ -68,12 +113,37 @@ void recieve_password_using_uart(uint8 * passArray_ptr);
 void options(uint8 * passArray_ptr);
 /*
  * Description: Function to store the password in EEPROM
+ * (new random salt and the salted hash of the password)
  * [Args] :
  *         [in]   : pointer to array where I will store password in (local array)
  */
 void store_password_in_EEPROM(uint8 * passArray_ptr);
+/*
+ * Description: Function to load the password record from EEPROM at start up
+ * (a record with an erased salt or a wrong number of digits is no password)
+ * [Args] :
+ *         [out]  : TRUE if a password is stored (g_pass_length is its number of digits)
+ */
+boolean load_password_record(void);
+/*
+ * Description: Function to compute SHA-256 of (salt , password)
+ * [Args] :
+ *         [in]   : pointer to the salt (SALT_SIZE bytes)
+ *         [in]   : pointer to the password (PASS_SIZE bytes)
+ *         [out]  : pointer to the digest (SHA256_DIGEST_SIZE bytes)
+ */
+void hash_password(const uint8 * salt_ptr,const uint8 * passArray_ptr,uint8 * digest_ptr);
+/*
+ * Description: Function to count the digits of a password (till the first PASS_NO_DIGIT nibble)
+ * [Args] :
+ *         [in]   : pointer to the password (PASS_SIZE bytes)
+ *         [out]  : number of digits
+ */
+uint8 password_length(const uint8 * passArray_ptr);
 /*
  * Description: Function to COMPARE the password in EEPROM WITH NEW PASSWORD
+ * (the whole record is read and compared , the time doesn't depend on the password ,
+ *  a password of another number of digits is wrong without reading the EEPROM)
  * [Args] :
  *         [in]   : pointer to array where I will store password in (local array)
  *         [out]   : TRUE_PASSWORD
@@ -82,70 +152,220 @@ void store_password_in_EEPROM(uint8 * passArray_ptr);
 uint8 check_password(uint8 * passArray_ptr);
 /*
  * Description:Function for
- *           1) MAKE the buzzer be ON (60 seconds)
- *              when user enter password three times wrong
- *              by set timer0 to calculate 60 seconds
- *           2) set timer call (wrong_password_off) after counting 60 seconds
+ *           1) MAKE the buzzer play the lockout alert
+ *              when user enter password LOCKOUT_ATTEMPTS times wrong (or in a lockout)
+ *           2) start the lockout timeline , timebase hook (wrong_password_off) ends it
+ *              when the lockout module ends the lockout (LOCKOUT_poll)
  */
 void wrong_password_on(void);
 /*
  * Description: Function for
- *         1) turn on motor with clock_wise for 30 second
+ *         1) turn on motor with clock_wise till the open end stop (15 second at most)
  *            when user enter password and choose option '+'
- *            by set timer0 to calculate 33 seconds
- *         2) set timer call (motor_off) after counting 60 seconds
+ *         2) start the door timeline , door position call back and timebase hook (motor_off) run it
  */
 void motor_on(void);
+/*
+ * Description: Function to publish every change of g_door_status to microcontroller1
+ * till the required final status is sent , and a countdown event every second
+ * (an obstruction event restarts the countdown)
+ * [Args] :
+ *         [in]   : status event that ends the sequence (STATUS_DOOR_CLOSED or STATUS_LOCKOUT_OFF)
+ *         [in]   : time of the whole sequence in ms from g_timeline_start
+ */
+void publish_door_status(uint8 last_status,uint32 total_time);
 /*******************************************************************************
  *                           Global Variables                                  *
  *******************************************************************************/
-uint16 g_tick=0;/* Global variable to counting times of timer *  */
+/* current state of motor/lockout , changed by the timebase hooks */
+volatile uint8 g_door_status=STATUS_DOOR_CLOSED;
+/* time stamp (ms) of start of door timeline or lockout */
+static volatile uint32 g_timeline_start=0;
+/* time stamp (ms) of start of the current door step (opening , hold or closing) */
+static volatile uint32 g_step_start=0;
+/* measured time (ms) of the last opening and closing travel from end stop to end stop ,
+ * the countdown of the next cycle uses them (the timeout till the first travel is measured)
+ */
+static volatile uint16 g_door_open_time=DOOR_TRAVEL_TIME_MS;
+static volatile uint16 g_door_close_time=DOOR_TRAVEL_TIME_MS;
+/* TRUE when the current travel started from an end stop (its time is recorded) */
+static volatile boolean g_door_travel_full=FALSE;
+/* set by the stall detection , cleared when the obstruction event is sent to microcontroller1 */
+static volatile boolean g_door_obstructed=FALSE;
+/* timing of the received bytes (timer1 cycles) , source of the random salt */
+static uint32 g_entropy=0;
+/* number of digits of the stored password (copy of the record field) , a password of another length
+ * is wrong without reading the EEPROM
+ */
+static uint8 g_pass_length=0;
+/* TRUE when the current travel is in its slow phase (near the end stop) */
+static volatile boolean g_door_slowing=FALSE;
+/* door motor speed profiles (same for opening and closing) :
+ * soft start then full speed till the door is near the end stop ,
+ * then slow (from the current speed) and crawl till the end stop stops the motor
+ */
+static const s_dcMotor_RampPoint g_door_ramp[] PROGMEM=
+{
+	{0,30},{500,100},
+	{DC_MOTOR_RAMP_END,0}
+};
+static const s_dcMotor_RampPoint g_door_slow_ramp[] PROGMEM=
+{
+	{0,100},{400,30},
+	{DC_MOTOR_RAMP_END,0}
+};
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 /*
- * Description: Function for call back for timer0
- * to deinit timer0 and turn off buzzer
+ * Description: timebase hook (every 1 ms)
+ * to turn off buzzer when the lockout time ends (the lockout module keeps the time)
  */
 void wrong_password_off(void)
 {
-	g_tick++;/*if NUMBER_OF_OVERFLOWS_for_1_SECOND occur so counter will added by 1 */
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*60)
+	if ((g_door_status==STATUS_LOCKOUT_ON)&&(!LOCKOUT_poll()))
 	{
 		BUZZER_off(); /*turn off buzzer */
-		g_tick=0;/*clear counter to count from 0 again*/
-		TIMER_0_deInit();/*turn off timer*/
+		g_door_status=STATUS_LOCKOUT_OFF;
 	}
 }
 /*
- * Description: Function for call back for timer0
- * to deinit timer0 and control motor
+ * Description: Function to end the current travel of the door (end stop reached or timeout)
+ * stop the motor , record the travel time and go to the next status
+ * [Args] :
+ *         [in]   : next status (STATUS_DOOR_OPEN or STATUS_DOOR_CLOSED)
+ *         [in]   : TRUE if the end stop is reached (FALSE : timeout)
  */
-void motor_off(void)
+static void door_travel_end(uint8 next_status,boolean end_stop_reached)
 {
-	g_tick++;/*if NUMBER_OF_OVERFLOWS_for_1_SECOND occur so counter will added by 1 */
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*15)
+	uint16 travel_time;
+	/*only a travel from end stop to end stop is recorded (not after an obstruction or a timeout) ,
+	 *with the slow phase started from the door position it is the shortest travel of this door
+	 */
+	boolean recorded=(g_door_travel_full&&end_stop_reached);
+	DcMotor_Rotate(DC_MOTOR_STOP);/*make motor off*/
+	CURRENT_SENSE_disarm();
+	travel_time=(uint16)TIMEBASE_elapsed(g_step_start);
+	if (recorded&&(next_status==STATUS_DOOR_OPEN))
 	{
-		DcMotor_Rotate(DC_MOTOR_STOP);/*make motor off*/
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_DOOR_OPEN);
+		g_door_open_time=travel_time;
 	}
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*18)
+	else if (recorded)
 	{
-
-		DcMotor_Rotate(DC_MOTOR_ACW);/*make motor on and anti_clockwise*/
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_DOOR_CLOSE);
+		g_door_close_time=travel_time;
+	}
+	g_step_start=TIMEBASE_now();
+	g_door_status=next_status;
+}
+/*
+ * Description: door position call back (external interrupt)
+ * to stop the motor as soon as the door reaches the end stop it moves to
+ */
+void door_reached(e_door_position_event event)
+{
+	if ((g_door_status==STATUS_DOOR_OPENING)&&(event==DOOR_POSITION_OPEN_REACHED))
+	{
+		door_travel_end(STATUS_DOOR_OPEN,TRUE);
 	}
-	if (g_tick==NUMBER_OF_OVERFLOWS_for_1_SECOND*33)
+	else if ((g_door_status==STATUS_DOOR_CLOSING)&&(event==DOOR_POSITION_CLOSED_REACHED))
+	{
+		door_travel_end(STATUS_DOOR_CLOSED,TRUE);
+	}
+}
+/*
+ * Description: current sense call back (ADC interrupt) when the motor stalls
+ * 1) closing : open the door again (nothing is trapped under it)
+ * 2) opening : stop the motor , the door is held then closed as usual
+ * the countdown restarts from the new step
+ */
+void door_obstructed(void)
+{
+	if (g_door_status==STATUS_DOOR_CLOSING)
+	{
+		DcMotor_rampRotate(DC_MOTOR_CW,g_door_ramp);/*make motor on and with_clockwise*/
+		CURRENT_SENSE_arm();
+		g_door_slowing=FALSE;
+		g_door_status=STATUS_DOOR_OPENING;
+	}
+	else if (g_door_status==STATUS_DOOR_OPENING)
 	{
-		TIMER_0_deInit();/*turn off timer*/
 		DcMotor_Rotate(DC_MOTOR_STOP);/*make motor off*/
-		g_tick=0;/*clear counter to count from 0 again*/
-
+		g_door_status=STATUS_DOOR_OPEN;
+	}
+	else
+	{
+		return;
+	}
+	g_door_travel_full=FALSE;
+	g_step_start=TIMEBASE_now();
+	g_timeline_start=g_step_start;
+	g_door_obstructed=TRUE;
+}
+/*
+ * Description: Function to check if the moving door is near the end stop it moves to
+ * (encoder count , or the time of the last measured travel without the encoder)
+ * [Args] :
+ *         [in]   : ms since the start of the travel
+ *         [out]  : TRUE when the slow phase must start
+ */
+static boolean door_near_end_stop(uint32 elapsed)
+{
+#if (DOOR_POSITION_ENCODER_ENABLE == TRUE)
+	sint16 count=DOOR_POSITION_getCount();
+	(void)elapsed;
+	if (g_door_status==STATUS_DOOR_OPENING)
+	{
+		return (count>=(DOOR_POSITION_OPEN_COUNT-DOOR_SLOW_COUNT));
+	}
+	return (count<=DOOR_SLOW_COUNT);
+#else
+	uint16 travel_time=(g_door_status==STATUS_DOOR_OPENING)?g_door_open_time:g_door_close_time;
+	return ((elapsed+DOOR_SLOW_TIME_MS)>=travel_time);
+#endif
+}
+/*
+ * Description: timebase hook (every 1 ms)
+ * to control motor along the door timeline
+ * (close the door after the hold time , slow down near the end stop ,
+ *  stop the motor if the end stop is not reached in time)
+ */
+void motor_off(void)
+{
+	uint32 elapsed=TIMEBASE_elapsed(g_step_start);
+	if ((g_door_status==STATUS_DOOR_OPENING)&&(elapsed>=DOOR_TRAVEL_TIME_MS))
+	{
+		door_travel_end(STATUS_DOOR_OPEN,FALSE);
+	}
+	else if ((g_door_status==STATUS_DOOR_OPEN)&&(elapsed>=DOOR_HOLD_TIME_MS))
+	{
+		DcMotor_rampRotate(DC_MOTOR_ACW,g_door_ramp);/*make motor on and anti_clockwise*/
+		CURRENT_SENSE_arm();
+		g_door_slowing=FALSE;
+		g_step_start=TIMEBASE_now();
+		/*a door stopped by an obstruction while opening closes from the middle*/
+		g_door_travel_full=DOOR_POSITION_isOpen();
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_DOOR_CLOSE);
+		g_door_status=STATUS_DOOR_CLOSING;
+	}
+	else if ((g_door_status==STATUS_DOOR_CLOSING)&&(elapsed>=DOOR_TRAVEL_TIME_MS))
+	{
+		door_travel_end(STATUS_DOOR_CLOSED,FALSE);
+	}
+	else if (((g_door_status==STATUS_DOOR_OPENING)||(g_door_status==STATUS_DOOR_CLOSING))&&
+			(!g_door_slowing)&&door_near_end_stop(elapsed))
+	{
+		/*slow phase from the door position , the door reaches the end stop crawling*/
+		DcMotor_rampChange(g_door_slow_ramp);
+		g_door_slowing=TRUE;
 	}
 }
 /*
  * Description: main Function
  *  1)initialize  all drivers
- *  2)receive password at first time
- *  3)store password in EEPROM
+ *  2)load the password record from EEPROM
+ *  3)no password stored (first start up) : receive password and store it in EEPROM
  *  4)in while (1) : options function
  */
 int main(void)
@@ -154,10 +374,17 @@ int main(void)
 
 	/*initialize  all drivers */
 	init_microcontroller();
-	/*receive password */
-	recieve_password_using_uart(pass_arr);
-	/*store password in EEPROM*/
-	store_password_in_EEPROM(pass_arr);
+	/*a stored password is changed only by option '-' after the old password (not by a reset)*/
+	if (!load_password_record())
+	{
+		/*receive password (microcontroller1 checks its length , an empty one is not stored)*/
+		do
+		{
+			recieve_password_using_uart(pass_arr);
+		} while (password_length(pass_arr)<PASS_MIN_DIGITS);
+		/*store password in EEPROM*/
+		store_password_in_EEPROM(pass_arr);
+	}
 	while(1)
 	{
 		options(pass_arr);/*call option function*/
@@ -167,18 +394,42 @@ int main(void)
 /*
  * Description: Function for initialize  all drivers
  *  1)Enable global interrupts
- *  2)dc_motor
- *  3)UART
+ *  2)dc_motor (with its speed PWM and ramps) , door position and motor current sensing
+ *  3)UART and link
  */
 void init_microcontroller(void)
 {
 	/*Enable global interrupts in MC by setting the I-Bit.*/
 	SREG |= (1<<7);
+	/*initialize the timebase (on timer1 of the timestamp) and add the door/lockout timelines to it*/
+	TIMESTAMP_init();
+	TIMEBASE_init();
+	if ((!TIMEBASE_addHook(motor_off))||(!TIMEBASE_addHook(wrong_password_off)))
+	{
+		TIMEBASE_halt(); /* no free timebase hook */
+	}
+	/*failed attempts and a lockout not served before the power off (internal EEPROM)*/
+	LOCKOUT_init();
+	/*initialize the BUZZER (tones on timer0)*/
+	BUZZER_init();
 	/*initialize the MOTOR*/
 	DcMotor_Init();
+	/*initialize the end stops , they stop the motor*/
+	DOOR_POSITION_init();
+	DOOR_POSITION_setCallBack(door_reached);
+	/*initialize the motor current sensing , it stops or reverses the motor*/
+	CURRENT_SENSE_init();
+	CURRENT_SENSE_setCallBack(door_obstructed);
 	/*initialize the UART*/
 	s_uart_ConfigType conf_1={_8_BITS_SIZE,DISABLED_PARITY,_1_BIT_STOP,9600};
 	UART_init(&conf_1);
+	/*all messages to microcontroller1 are encrypted frames*/
+	if(!LINK_init())
+	{
+		/*the key is not programmed (link_key.py) , no password is taken without it*/
+		BUZZER_playAlert(BUZZER_ALERT_LOCKOUT);
+		while(1){}
+	}
 	/* Initialize the TWI/I2C Driver */
 	const s_TWI_ConfigType  Config={0x01,PRESCCALER_1,FAST_MODE};
 	TWI_init(&Config);
@@ -190,35 +441,118 @@ void init_microcontroller(void)
  */
 void recieve_password_using_uart(uint8 * passArray_ptr)
 {
-	uint8 loop_count; /*counter to use it in for_loop*/
+	uint8 ready[1+LINK_CHALLENGE_SIZE]={MC2_READY}; /*MC2_READY then the challenge of this transaction*/
+	uint8 request; /*byte received from microcontroller1*/
 
 	/*you can delete this check */
-	/*for checking that two microcontrollers working in same time */
-	while(UART_recieveByte() != MC1_READY){}
-	/* Send MC2_READY byte to MC1 to ask it to send the string */
-	UART_sendByte(MC2_READY);
-
-	for (loop_count=0;loop_count<PASS_SIZE;loop_count++)
+	/*for checking that two microcontrollers working in same time (new transaction)*/
+	LINK_bind(NULL_PTR);
+	while((request=LINK_receiveByte()) != MC1_READY)
 	{
-		passArray_ptr[loop_count]=UART_recieveByte();
+		if (request==MC1_PASS_QUERY)
+		{
+			/*microcontroller1 starts up : it asks for a new password only if none is stored*/
+			LINK_sendByte((g_pass_length!=0)?PASS_STORED:PASS_NOT_STORED);
+		}
 	}
+	/*the cycle a frame arrives at depends on the user typing*/
+	g_entropy=((g_entropy<<7)|(g_entropy>>25))^TIMESTAMP_now();
+	/* Send MC2_READY byte and a fresh challenge to MC1 to ask it to send the string */
+	LINK_newChallenge(&ready[1]);
+	LINK_send(ready,sizeof(ready));
+	/*the password , the verdict and the option are bound to the challenge (a recorded command is not accepted again)*/
+	LINK_bind(&ready[1]);
+
+	LINK_receive(passArray_ptr,PASS_SIZE);
+	g_entropy=((g_entropy<<7)|(g_entropy>>25))^TIMESTAMP_now();
 }
 /*
  * Description: Function to store the password in EEPROM
+ * (new random salt and the salted hash of the password)
  * [Args] :
  *         [in]   : pointer to array where I will store password in (local array)
  */
 void store_password_in_EEPROM(uint8 * passArray_ptr)
+{
+	uint8 record[PASS_RECORD_SIZE]; /*salt then digest*/
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint32 now=TIMESTAMP_now();
+	s_sha256_Context context;
+	/*salt : hash of the key timings and the time now*/
+	SHA256_init(&context);
+	SHA256_update(&context,(const uint8 *)&g_entropy,sizeof(g_entropy));
+	SHA256_update(&context,(const uint8 *)&now,sizeof(now));
+	SHA256_final(&context,digest);
+	memcpy(record,digest,SALT_SIZE);
+	g_pass_length=password_length(passArray_ptr);
+	record[PASS_LENGTH_OFFSET]=g_pass_length;
+	hash_password(record,passArray_ptr,&record[PASS_DIGEST_OFFSET]);
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_EEPROM_WRITE);
+	EEPROM_writeBlock(address_in_eeprom,record,PASS_RECORD_SIZE);
+	TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_EEPROM_WRITE);
+}
+/*
+ * Description: Function to load the password record from EEPROM at start up
+ * (a record with an erased salt or a wrong number of digits is no password)
+ * [Args] :
+ *         [out]  : TRUE if a password is stored (g_pass_length is its number of digits)
+ */
+boolean load_password_record(void)
 {
 	uint8 loop_count; /*counter to use it in for_loop*/
-	uint16 address_eeprom=address_in_eeprom;
-	for (loop_count=0;loop_count<PASS_SIZE;loop_count++)
+	uint8 record[PASS_RECORD_SIZE]; /*salt then digest*/
+	uint8 erased=0xFF; /*AND of the salt bytes*/
+	/*a bus error is not taken as an erased EEPROM (it would let a new password be set) , read again*/
+	while (EEPROM_readBlock(address_in_eeprom,record,PASS_RECORD_SIZE)==ERROR){}
+	for (loop_count=0;loop_count<SALT_SIZE;loop_count++)
+	{
+		erased&=record[loop_count];
+	}
+	if ((erased==0xFF)||(record[PASS_LENGTH_OFFSET]<PASS_MIN_DIGITS)||(record[PASS_LENGTH_OFFSET]>PASS_MAX_DIGITS))
+	{
+		g_pass_length=0;
+		return FALSE;
+	}
+	g_pass_length=record[PASS_LENGTH_OFFSET];
+	return TRUE;
+}
+/*
+ * Description: Function to compute SHA-256 of (salt , password)
+ * [Args] :
+ *         [in]   : pointer to the salt (SALT_SIZE bytes)
+ *         [in]   : pointer to the password (PASS_SIZE bytes)
+ *         [out]  : pointer to the digest (SHA256_DIGEST_SIZE bytes)
+ */
+void hash_password(const uint8 * salt_ptr,const uint8 * passArray_ptr,uint8 * digest_ptr)
+{
+	s_sha256_Context context;
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_HASH);
+	SHA256_init(&context);
+	SHA256_update(&context,salt_ptr,SALT_SIZE);
+	SHA256_update(&context,passArray_ptr,PASS_SIZE);
+	SHA256_final(&context,digest_ptr);
+	TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_HASH);
+}
+/*
+ * Description: Function to count the digits of a password (till the first PASS_NO_DIGIT nibble)
+ * [Args] :
+ *         [in]   : pointer to the password (PASS_SIZE bytes)
+ *         [out]  : number of digits
+ */
+uint8 password_length(const uint8 * passArray_ptr)
+{
+	uint8 length; /*digits counted*/
+	uint8 digit;
+	for (length=0;length<PASS_MAX_DIGITS;length++)
 	{
-		address_eeprom+=loop_count;
-		/* store elements of password in EEPROM*/
-		EEPROM_writeByte(address_eeprom,passArray_ptr[loop_count]); /* Write 0x0F in the external EEPROM */
-		_delay_ms(20);
+		digit=passArray_ptr[length/2];
+		digit=(length&1)?(digit&0x0F):(digit>>4);
+		if (digit>9)
+		{
+			break;
+		}
 	}
+	return length;
 }
 /*
  * Description: Function to interfacing with micro1
@@ -229,31 +563,45 @@ void store_password_in_EEPROM(uint8 * passArray_ptr)
  */
 void options(uint8 * passArray_ptr)
 {
-	/*receive password */
-	recieve_password_using_uart(passArray_ptr);
-	if (check_password(passArray_ptr))/*if password is true check will return 1(TRUE_PASSWORD)*/
+	uint8 verdict; /*TRUE_PASSWORD or WRONG_PASSWORD*/
+	uint32 verify_start; /*cycle of the last password byte*/
+	uint8 option; /*'+' or '-'*/
+	while(1)
 	{
-		UART_sendByte(TRUE_PASSWORD);/*sent to micro1 TEUE_PASSWORD */
-		if(UART_recieveByte()=='-')
+		/*a lockout ended since the last attempt is saved served before waiting (out of the verify time)*/
+		LOCKOUT_saveServed();
+		/*receive password */
+		recieve_password_using_uart(passArray_ptr);
+		verify_start=TIMESTAMP_now();
+		TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_VERIFY);
+		if (LOCKOUT_isActive())
 		{
-			/*receive password */
-			recieve_password_using_uart(passArray_ptr);
-			/*store password in EEPROM*/
-			store_password_in_EEPROM(passArray_ptr);
+			/*no password is checked till the lockout is over*/
+			verdict=WRONG_PASSWORD;
 		}
 		else
 		{
-			motor_on();/*function call to control motor */
+			/*the attempt is stored as failed first , removing the power after a wrong verdict doesn't reset it*/
+			LOCKOUT_attempt();
+			verdict=check_password(passArray_ptr);
+			if (verdict!=TRUE_PASSWORD)
+			{
+				/*no EEPROM write , the lockout starts after LOCKOUT_ATTEMPTS failures*/
+				LOCKOUT_result(FALSE);
+			}
 		}
-	}
-	else
-	{
-		UART_sendByte(WRONG_PASSWORD);/*sent to micro1 WRONG_PASSWORD */
-		recieve_password_using_uart(passArray_ptr);
-		if (check_password(passArray_ptr))/*if password is true check will return 1(TRUE_PASSWORD)*/
+		TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_VERIFY);
+		/*send the verdict at a fixed time , the delay doesn't show the result*/
+		while((TIMESTAMP_now()-verify_start)<VERIFY_TIME_CYCLES){}
+		if (verdict)/*if password is true check will return 1(TRUE_PASSWORD)*/
 		{
-			UART_sendByte(TRUE_PASSWORD);/*sent to micro1 TEUE_PASSWORD */
-			if(UART_recieveByte()=='-')
+			LINK_sendByte(TRUE_PASSWORD);/*sent to micro1 TEUE_PASSWORD */
+			/*clear the failures counter after the verdict (its EEPROM write is out of the verify time)*/
+			LOCKOUT_result(TRUE);
+			BUZZER_playAlert(BUZZER_ALERT_SUCCESS);
+			option=LINK_receiveByte();
+			BUZZER_playAlert(BUZZER_ALERT_CLICK);
+			if(option=='-')
 			{
 				/*receive password */
 				recieve_password_using_uart(passArray_ptr);
@@ -263,39 +611,75 @@ void options(uint8 * passArray_ptr)
 			else
 			{
 				motor_on();/*function call to control motor */
+				/*countdown from the travel times measured in the last cycle*/
+				publish_door_status(STATUS_DOOR_CLOSED,(uint32)g_door_open_time+DOOR_HOLD_TIME_MS+g_door_close_time);
 			}
+			return;
 		}
-		else
+		if (LOCKOUT_isActive())
 		{
-			UART_sendByte(WRONG_PASSWORD);/*sent to micro1 WRONG_PASSWORD */
-			recieve_password_using_uart(passArray_ptr);
-			if (check_password(passArray_ptr))/*if password is true check will return 1(TRUE_PASSWORD)*/
+			/* lockout alert till the lockout ends (its time doubles with every lockout) */
+			LINK_sendByte(LOCKED_OUT);/*sent to micro1 LOCKED_OUT , the lockout status events follow*/
+			wrong_password_on();
+			/*the countdown shows the time left , the lockout module ends the lockout (STATUS_LOCKOUT_OFF)*/
+			publish_door_status(STATUS_LOCKOUT_OFF,LOCKOUT_remaining());
+			/*the lockout ended : save it served*/
+			LOCKOUT_saveServed();
+			return;
+		}
+		LINK_sendByte(WRONG_PASSWORD);/*sent to micro1 WRONG_PASSWORD */
+		BUZZER_playAlert(BUZZER_ALERT_WRONG_CODE);
+	}
+}
+/*
+ * Description: Function to publish every change of g_door_status to microcontroller1
+ * till the required final status is sent , and a countdown event every second
+ * (an obstruction event restarts the countdown)
+ * [Args] :
+ *         [in]   : status event that ends the sequence (STATUS_DOOR_CLOSED or STATUS_LOCKOUT_OFF)
+ *         [in]   : time of the whole sequence in ms from g_timeline_start
+ */
+void publish_door_status(uint8 last_status,uint32 total_time)
+{
+	uint8 published; /*last status sent to micro1*/
+	uint16 published_remaining=0xFFFF; /*last seconds left sent to micro1*/
+	uint16 remaining; /*seconds left (rounded up)*/
+	uint32 elapsed; /*ms since the start of the sequence*/
+	uint8 countdown[3]={STATUS_COUNTDOWN,0,0}; /*countdown event and the seconds left*/
+	do
+	{
+		if (g_door_obstructed)
+		{
+			g_door_obstructed=FALSE;
+			LINK_sendByte(STATUS_DOOR_OBSTRUCTED);
+			published_remaining=0xFFFF; /*new countdown*/
+		}
+		published=g_door_status;
+		LINK_sendByte(published);
+		/*wait till the timebase hooks change the status , send the seconds left when they change*/
+		while((g_door_status==published)&&(!g_door_obstructed))
+		{
+			elapsed=TIMEBASE_elapsed(g_timeline_start);
+			if (elapsed>total_time)
 			{
-				UART_sendByte(TRUE_PASSWORD);/*sent to micro1 TEUE_PASSWORD */
-				if(UART_recieveByte()=='-')
-				{
-					/*receive password */
-					recieve_password_using_uart(passArray_ptr);
-					/*store password in EEPROM*/
-					store_password_in_EEPROM(passArray_ptr);
-				}
-				else
-				{
-					motor_on();/*function call to control motor */
-				}
+				elapsed=total_time;
 			}
-			else
+			remaining=(uint16)((total_time-elapsed+TIMEBASE_SECONDS(1)-1)/TIMEBASE_SECONDS(1));
+			if (remaining!=published_remaining)
 			{
-				UART_sendByte(WRONG_PASSWORD);/*sent to micro1 WRONG_PASSWORD */
-				/* turn on timer and buzzer for 1 minute */
-				wrong_password_on();
+				countdown[1]=(uint8)(remaining>>8);
+				countdown[2]=(uint8)remaining;
+				LINK_send(countdown,3);
+				published_remaining=remaining;
 			}
 		}
-	}
-
+	} while (g_door_status!=last_status);
+	LINK_sendByte(last_status);
 }
 /*
  * Description: Function to COMPARE the password in EEPROM WITH NEW PASSWORD
+ * (the whole record is read and compared , the time doesn't depend on the password ,
+ *  a password of another number of digits is wrong without reading the EEPROM)
  * [Args] :
  *         [in]   : pointer to array where I will store password in (local array)
  *         [out]   : TRUE_PASSWORD
@@ -304,51 +688,59 @@ void options(uint8 * passArray_ptr)
 uint8 check_password(uint8 * passArray_ptr)
 {
 	uint8 loop_count; /*counter to use it in for_loop*/
-	uint16 address_eeprom=address_in_eeprom;
-	uint8 key;
-	for (loop_count=0;loop_count<PASS_SIZE;loop_count++)
+	uint8 record[PASS_RECORD_SIZE]; /*salt then digest*/
+	uint8 digest[SHA256_DIGEST_SIZE];
+	uint8 difference=0; /*OR of the differences of all digest bytes*/
+	uint8 length=password_length(passArray_ptr);
+	/* wrong number of digits : no EEPROM access (the verdict is sent at a fixed time anyway) */
+	if ((length<PASS_MIN_DIGITS)||(length!=g_pass_length))
+	{
+		return WRONG_PASSWORD;
+	}
+	/* read the password record from EEPROM in one transaction*/
+	if (EEPROM_readBlock(address_in_eeprom,record,PASS_RECORD_SIZE)==ERROR)
 	{
-		address_eeprom+=loop_count;
-		/* read elements of password in EEPROM*/
-		EEPROM_readByte(address_eeprom,&key);
-		_delay_ms(20);
-		if (key!=passArray_ptr[loop_count])
-			return WRONG_PASSWORD;
+		/*still hashed and compared so a bus error takes the same time*/
+		difference=1;
 	}
-	return TRUE_PASSWORD;
+	/*the digits count of the record must match too*/
+	difference|=(uint8)(record[PASS_LENGTH_OFFSET]^length);
+	hash_password(record,passArray_ptr,digest);
+	/*no exit at the first wrong byte*/
+	for (loop_count=0;loop_count<SHA256_DIGEST_SIZE;loop_count++)
+	{
+		difference|=(uint8)(digest[loop_count]^record[PASS_DIGEST_OFFSET+loop_count]);
+	}
+	return (difference==0)?TRUE_PASSWORD:WRONG_PASSWORD;
 }
 /*
  * Description:Function for
- *           1) MAKE the buzzer be ON (60 seconds)
- *              when user enter password three times wrong
- *              by set timer0 to calculate 60 seconds
- *           2) set timer call (wrong_password_off) after counting 60 seconds
+ *           1) MAKE the buzzer play the lockout alert
+ *              when user enter password LOCKOUT_ATTEMPTS times wrong (or in a lockout)
+ *           2) start the lockout timeline , timebase hook (wrong_password_off) ends it
+ *              when the lockout module ends the lockout (LOCKOUT_poll)
  */
 void wrong_password_on(void)
 {
-	/*initialize the BUZZER*/
-	BUZZER_init();
-	BUZZER_on();
-	/*initialize the timer0*/
-	s_timer_0_ConfigType conf={6,0,F_CPU_1024,NORMAL__MODE};
-	TIMER_0_init(&conf);
-	/*set call back for timer */
-	TIMER_0_setCallBack(wrong_password_off);
+	BUZZER_playAlert(BUZZER_ALERT_LOCKOUT);
+	g_timeline_start=TIMEBASE_now();
+	g_door_status=STATUS_LOCKOUT_ON;
 }
 /*
  * Description: Function for
- *         1) turn on motor with clock_wise for 30 second
+ *         1) turn on motor with clock_wise till the open end stop (15 second at most)
  *            when user enter password and choose option '+'
- *            by set timer0 to calculate 33 seconds
- *         2) set timer call (motor_off) after counting 60 seconds
+ *         2) start the door timeline , door position call back and timebase hook (motor_off) run it
  */
 void motor_on(void)
 {
-	DcMotor_Rotate(DC_MOTOR_CW);/*make motor on and with_clockwise*/
-	/*initialize the timer0*/
-	s_timer_0_ConfigType conf={0,250,F_CPU_1024,CTC_MODE};
-	TIMER_0_init(&conf);
-	/*set call back for timer */
-	TIMER_0_setCallBack(motor_off);
+	g_timeline_start=TIMEBASE_now();
+	g_step_start=g_timeline_start;
+	g_door_travel_full=TRUE;
+	g_door_slowing=FALSE;
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_DOOR_OPEN);
+	g_door_status=STATUS_DOOR_OPENING;
+	DcMotor_rampRotate(DC_MOTOR_CW,g_door_ramp);/*make motor on and with_clockwise*/
+	CURRENT_SENSE_arm();
 }
 
@@ -0,0 +1,64 @@
+/******************************************************************************
+ *
+ * Module: PWM
+ *
+ * File Name: pwm.c
+ *
+ * Description: Source file for the timer2 fast PWM driver (output on OC2)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"pwm.h"
+#include"gpio.h"
+#include <avr/io.h>
+#include <util/atomic.h>
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize timer2 in fast PWM mode
+ * 	1. non-inverting output on OC2 , clock F_CPU/8 (3.9 KHZ at 8MHZ)
+ * 	2. the output starts low (duty 0)
+ */
+void PWM_Timer2_init(void)
+{
+	GPIO_PIN_LOW(PWM_OC2_PIN);
+	GPIO_PIN_OUTPUT(PWM_OC2_PIN);
+	TCNT2=0;
+	OCR2=0;
+	/* fast PWM (WGM21:0=3) , OC2 disconnected till a duty between 0 and 100 is set , clock F_CPU/8 */
+	TCCR2=(1<<WGM20)|(1<<WGM21)|(1<<CS21);
+}
+/*
+ * Description: Function to set the duty cycle (0 to PWM_MAX_DUTY percent) of OC2
+ */
+void PWM_Timer2_setDuty(uint8 duty_cycle)
+{
+	/* called from main and from interrupts (ramp hook , current sense) ,
+	 * TCCR2 is out of the SBI/CBI range : its read-modify-write must not be split
+	 */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if(duty_cycle==0)
+		{
+			/* fast PWM compare 0 still gives one count pulse , hold the pin low */
+			TCCR2&=~(1<<COM21);
+			GPIO_PIN_LOW(PWM_OC2_PIN);
+		}
+		else if(duty_cycle>=PWM_MAX_DUTY)
+		{
+			TCCR2&=~(1<<COM21);
+			GPIO_PIN_HIGH(PWM_OC2_PIN);
+		}
+		else
+		{
+			OCR2=(uint8)(((uint16)duty_cycle*255)/PWM_MAX_DUTY);
+			/* non-inverting : clear OC2 on compare match , set at bottom */
+			TCCR2|=(1<<COM21);
+		}
+	}
+}
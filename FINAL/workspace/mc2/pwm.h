@@ -0,0 +1,39 @@
+/******************************************************************************
+ *
+ * Module: PWM
+ *
+ * File Name: pwm.h
+ *
+ * Description: Header file for the timer2 fast PWM driver (output on OC2)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef PWM_H_
+#define PWM_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* OC2 pin of timer2 (compile time pin , see GPIO_PIN) */
+#define PWM_OC2_PIN               GPIO_PIN(D,PIN7_ID)
+/* maximum duty cycle in percent */
+#define PWM_MAX_DUTY              100
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize timer2 in fast PWM mode
+ * 	1. non-inverting output on OC2 , clock F_CPU/8 (3.9 KHZ at 8MHZ)
+ * 	2. the output starts low (duty 0)
+ */
+void PWM_Timer2_init(void);
+/*
+ * Description: Function to set the duty cycle (0 to PWM_MAX_DUTY percent) of OC2
+ * 0 and PWM_MAX_DUTY disconnect the timer and hold the pin low/high (no spike of one timer count)
+ */
+void PWM_Timer2_setDuty(uint8 duty_cycle);
+#endif /* PWM_H_ */
@@ -0,0 +1,176 @@
+/******************************************************************************
+ *
+ * Module: sha256
+ *
+ * File Name: sha256.c
+ *
+ * Description: Source file for the SHA-256 hash (round constants in flash)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"sha256.h"
+#include <avr/pgmspace.h>
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+#define SHA256_ROTR(x,n)          (((x)>>(n))|((x)<<(32-(n))))
+#define SHA256_SIGMA0(x)          (SHA256_ROTR(x,2)^SHA256_ROTR(x,13)^SHA256_ROTR(x,22))
+#define SHA256_SIGMA1(x)          (SHA256_ROTR(x,6)^SHA256_ROTR(x,11)^SHA256_ROTR(x,25))
+#define SHA256_GAMMA0(x)          (SHA256_ROTR(x,7)^SHA256_ROTR(x,18)^((x)>>3))
+#define SHA256_GAMMA1(x)          (SHA256_ROTR(x,17)^SHA256_ROTR(x,19)^((x)>>10))
+#define SHA256_CH(x,y,z)          ((z)^((x)&((y)^(z))))
+#define SHA256_MAJ(x,y,z)         (((x)&(y))|((z)&((x)|(y))))
+/* round (i) : the 16 words schedule is used as a ring , word i is ready before the round */
+#define SHA256_ROUND(a,b,c,d,e,f,g,h,i) \
+	do{ \
+		uint32 t1=(h)+SHA256_SIGMA1(e)+SHA256_CH(e,f,g)+pgm_read_dword(&g_sha256_k[i])+w[(i)&15]; \
+		(d)+=t1; \
+		(h)=t1+SHA256_SIGMA0(a)+SHA256_MAJ(a,b,c); \
+	}while(0)
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* round constants */
+static const uint32 g_sha256_k[64] PROGMEM=
+{
+	0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+	0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+	0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+	0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+	0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+	0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+	0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+	0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+};
+/* initial hash state */
+static const uint32 g_sha256_init[8] PROGMEM=
+{
+	0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+};
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: Function to compute the schedule words (first) to (first+count-1) in the ring
+ */
+static void SHA256_schedule(uint32 * w,uint8 first,uint8 count)
+{
+	uint8 i;
+	for(i=first;i<(uint8)(first+count);i++)
+	{
+		w[i&15]+=SHA256_GAMMA1(w[(i-2)&15])+w[(i-7)&15]+SHA256_GAMMA0(w[(i-15)&15]);
+	}
+}
+/*
+ * Description: Function to hash the full block of the context
+ */
+static void SHA256_transform(s_sha256_Context * context_ptr)
+{
+	uint32 w[16];
+	uint32 a,b,c,d,e,f,g,h;
+	uint8 i;
+	for(i=0;i<16;i++)
+	{
+		w[i]=((uint32)context_ptr->block[4*i]<<24)|((uint32)context_ptr->block[4*i+1]<<16)|
+				((uint32)context_ptr->block[4*i+2]<<8)|(uint32)context_ptr->block[4*i+3];
+	}
+	a=context_ptr->state[0];b=context_ptr->state[1];c=context_ptr->state[2];d=context_ptr->state[3];
+	e=context_ptr->state[4];f=context_ptr->state[5];g=context_ptr->state[6];h=context_ptr->state[7];
+#if (SHA256_UNROLLED == TRUE)
+	for(i=0;i<64;i+=8)
+	{
+		if(i>=16)
+		{
+			SHA256_schedule(w,i,8);
+		}
+		SHA256_ROUND(a,b,c,d,e,f,g,h,i);
+		SHA256_ROUND(h,a,b,c,d,e,f,g,i+1);
+		SHA256_ROUND(g,h,a,b,c,d,e,f,i+2);
+		SHA256_ROUND(f,g,h,a,b,c,d,e,i+3);
+		SHA256_ROUND(e,f,g,h,a,b,c,d,i+4);
+		SHA256_ROUND(d,e,f,g,h,a,b,c,i+5);
+		SHA256_ROUND(c,d,e,f,g,h,a,b,i+6);
+		SHA256_ROUND(b,c,d,e,f,g,h,a,i+7);
+	}
+#else
+	for(i=0;i<64;i++)
+	{
+		uint32 t;
+		if(i>=16)
+		{
+			SHA256_schedule(w,i,1);
+		}
+		SHA256_ROUND(a,b,c,d,e,f,g,h,i);
+		t=h;h=g;g=f;f=e;e=d;d=c;c=b;b=a;a=t;
+	}
+#endif
+	context_ptr->state[0]+=a;context_ptr->state[1]+=b;context_ptr->state[2]+=c;context_ptr->state[3]+=d;
+	context_ptr->state[4]+=e;context_ptr->state[5]+=f;context_ptr->state[6]+=g;context_ptr->state[7]+=h;
+}
+/*
+ * Description: Function to start a new hash
+ */
+void SHA256_init(s_sha256_Context * context_ptr)
+{
+	uint8 i;
+	for(i=0;i<8;i++)
+	{
+		context_ptr->state[i]=pgm_read_dword(&g_sha256_init[i]);
+	}
+	context_ptr->length=0;
+	context_ptr->used=0;
+}
+/*
+ * Description: Function to add (length) bytes to the hash
+ */
+void SHA256_update(s_sha256_Context * context_ptr,const uint8 * data_ptr,uint16 length)
+{
+	context_ptr->length+=length;
+	while(length--)
+	{
+		context_ptr->block[context_ptr->used++]=*data_ptr++;
+		if(context_ptr->used==SHA256_BLOCK_SIZE)
+		{
+			SHA256_transform(context_ptr);
+			context_ptr->used=0;
+		}
+	}
+}
+/*
+ * Description: Function to pad the message and write the 32 bytes digest
+ */
+void SHA256_final(s_sha256_Context * context_ptr,uint8 * digest_ptr)
+{
+	uint8 i;
+	uint32 bits_low=context_ptr->length<<3;
+	uint8 bits_high=(uint8)(context_ptr->length>>29);
+	/* 0x80 , zeros till 8 bytes are left in the block , then the length in bits (big endian) */
+	context_ptr->block[context_ptr->used++]=0x80;
+	if(context_ptr->used>(SHA256_BLOCK_SIZE-8))
+	{
+		while(context_ptr->used<SHA256_BLOCK_SIZE)
+		{
+			context_ptr->block[context_ptr->used++]=0;
+		}
+		SHA256_transform(context_ptr);
+		context_ptr->used=0;
+	}
+	while(context_ptr->used<(SHA256_BLOCK_SIZE-5))
+	{
+		context_ptr->block[context_ptr->used++]=0;
+	}
+	context_ptr->block[SHA256_BLOCK_SIZE-5]=bits_high;
+	for(i=0;i<4;i++)
+	{
+		context_ptr->block[SHA256_BLOCK_SIZE-1-i]=(uint8)(bits_low>>(8*i));
+	}
+	SHA256_transform(context_ptr);
+	for(i=0;i<SHA256_DIGEST_SIZE;i++)
+	{
+		digest_ptr[i]=(uint8)(context_ptr->state[i>>2]>>(24-8*(i&3)));
+	}
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+ *
+ * Module: sha256
+ *
+ * File Name: sha256.h
+ *
+ * Description: Header file for the SHA-256 hash (round constants in flash)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef SHA256_H_
+#define SHA256_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+#define SHA256_DIGEST_SIZE        32
+#define SHA256_BLOCK_SIZE         64
+/* TRUE : 8 rounds per loop with the working variables renamed (faster , about 2 KB more flash)
+ * FALSE : one round per loop with the working variables moved (smallest)
+ */
+#define SHA256_UNROLLED           TRUE
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*******************************************************************************
+ *  Structure name : s_sha256_Context
+ *  Structure Description:
+ *  this Structure is responsible for
+ *  1-hash state
+ *  2-number of bytes hashed
+ *  3-bytes of the block not hashed yet
+ */
+typedef struct
+{
+	uint32 state[8];
+	uint32 length;
+	uint8 block[SHA256_BLOCK_SIZE];
+	uint8 used;
+}s_sha256_Context;
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ * Description: Function to start a new hash
+ */
+void SHA256_init(s_sha256_Context * context_ptr);
+/*
+ * Description: Function to add (length) bytes to the hash
+ */
+void SHA256_update(s_sha256_Context * context_ptr,const uint8 * data_ptr,uint16 length);
+/*
+ * Description: Function to pad the message and write the 32 bytes digest
+ */
+void SHA256_final(s_sha256_Context * context_ptr,uint8 * digest_ptr);
+#endif /* SHA256_H_ */
@@ -0,0 +1,191 @@
+/******************************************************************************
+ *
+ * Module: timebase
+ *
+ * File Name: timebase.c
+ *
+ * Description: source file for the millisecond timebase
+ *              (built on timer0 CTC mode or on compare B of the free running timer1)
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"timebase.h"
+#include"timestamp.h"
+#include <util/atomic.h> /* To read the 32 bit counter without tearing */
+#if (TIMEBASE_SOURCE == TIMEBASE_TIMER0)
+#include"timer0.h"
+#else
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#endif
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+#if (TIMEBASE_SOURCE == TIMEBASE_TIMER0)
+/* timer counts per second and its whole/fraction parts per ms */
+#define TIMEBASE_COUNTS_PER_SECOND   (F_CPU/TIMEBASE_PRESCALER)
+#define TIMEBASE_COUNTS_PER_MS       (TIMEBASE_COUNTS_PER_SECOND/1000UL)
+#define TIMEBASE_FRACTION_PER_MS     (TIMEBASE_COUNTS_PER_SECOND%1000UL) /* in 1/1000 count */
+
+#if ((TIMEBASE_COUNTS_PER_MS<2) || (TIMEBASE_COUNTS_PER_MS>255))
+#error "TIMEBASE_PRESCALER doesn't fit 1 ms in timer0 for this F_CPU"
+#endif
+#else
+/* timer1 counts CPU cycles (timestamp driver) , compare B is moved forward by 1 ms each tick */
+#define TIMEBASE_COUNTS_PER_MS       (F_CPU/1000UL)
+
+#if (((F_CPU%1000UL)!=0) || (TIMEBASE_COUNTS_PER_MS>0xFFFF))
+#error "1 ms is not a whole number of timer1 counts below 65536 for this F_CPU"
+#endif
+#endif
+/*******************************************************************************
+ *                           Global Variables                                  *
+ *******************************************************************************/
+/* ms since TIMEBASE_init */
+static volatile uint32 g_timebase_ms=0;
+#if (TIMEBASE_SOURCE == TIMEBASE_TIMER0)
+/* accumulated fraction of timer count (in 1/1000 count) */
+static uint16 g_timebase_fraction=0;
+#endif
+/* functions called every 1 ms */
+static void (*g_timebase_hooks[TIMEBASE_MAX_HOOKS])(void);
+static uint8 g_timebase_hooksCount=0;
+/*******************************************************************************
+ *                      Functions Definitions                                  *
+ *******************************************************************************/
+/*
+ * Description: Function for call back for timer0 (every compare match = 1 ms)
+ * or called from the timer1 compare B interrupt
+ */
+static void TIMEBASE_tick(void)
+{
+	uint8 hook;
+	TIMESTAMP_SPAN_BEGIN(TIMESTAMP_SPAN_TIMEBASE_ISR);
+	g_timebase_ms++;
+
+#if (TIMEBASE_SOURCE == TIMEBASE_TIMER0)
+	/* lengthen the next period by one count when the fraction completes a whole count */
+	g_timebase_fraction+=TIMEBASE_FRACTION_PER_MS;
+	if (g_timebase_fraction>=1000)
+	{
+		g_timebase_fraction-=1000;
+		TIMER_0_setCompareValue(TIMEBASE_COUNTS_PER_MS);
+	}
+	else
+	{
+		TIMER_0_setCompareValue(TIMEBASE_COUNTS_PER_MS-1);
+	}
+#endif
+
+	for (hook=0;hook<g_timebase_hooksCount;hook++)
+	{
+		(*g_timebase_hooks[hook])();
+	}
+	TIMESTAMP_SPAN_END(TIMESTAMP_SPAN_TIMEBASE_ISR);
+}
+#if (TIMEBASE_SOURCE == TIMEBASE_TIMER1_COMPARE_B)
+/*
+ * Description: timer1 compare B , the next compare is exactly 1 ms after this one (no drift)
+ */
+ISR(TIMER1_COMPB_vect)
+{
+	OCR1B+=TIMEBASE_COUNTS_PER_MS;
+	TIMEBASE_tick();
+}
+#endif
+/*
+ *  Description : Function to initialize the timebase
+ * 	1. start timer0 in CTC mode with one compare match every 1 ms
+ * 	2. the fraction of timer count per ms (F_CPU not multiple of 64000) is
+ * 	   accumulated and one extra count is added when it reaches a whole count
+ * 	   so long periods don't drift
+ * 	or (TIMEBASE_TIMER1_COMPARE_B) one timer1 compare B interrupt every 1 ms
+ * 	Note: global interrupts must be enabled
+ */
+void TIMEBASE_init(void)
+{
+#if (TIMEBASE_SOURCE == TIMEBASE_TIMER0)
+	/* compare value N counts from 0 to N (N+1 counts) */
+	s_timer_0_ConfigType conf={0,TIMEBASE_COUNTS_PER_MS-1,F_CPU_64,CTC_MODE};
+	TIMER_0_setCallBack(TIMEBASE_tick);
+	TIMER_0_init(&conf);
+#else
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		OCR1B=TCNT1+TIMEBASE_COUNTS_PER_MS;
+		TIFR=(1<<OCF1B); /* clear an old compare flag */
+		TIMSK|=(1<<OCIE1B);
+	}
+#endif
+}
+/*
+ * Description: Function to return the number of ms since TIMEBASE_init (monotonic ,wraps after 49 days)
+ */
+uint32 TIMEBASE_now(void)
+{
+	uint32 now;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		now=g_timebase_ms;
+	}
+	return now;
+}
+/*
+ * Description: Function to return the number of ms passed since the (since) time stamp
+ * (correct across the wrap of TIMEBASE_now)
+ */
+uint32 TIMEBASE_elapsed(uint32 since)
+{
+	return TIMEBASE_now()-since;
+}
+/*
+ * Description: Function to check if (period) ms are passed since the (since) time stamp
+ * [out] : TRUE or FALSE
+ */
+boolean TIMEBASE_hasElapsed(uint32 since,uint32 period)
+{
+	return (TIMEBASE_elapsed(since)>=period) ? TRUE : FALSE;
+}
+/*
+ * Description: Function to wait (period) ms
+ */
+void TIMEBASE_delayMs(uint32 period)
+{
+	uint32 start=TIMEBASE_now();
+	while(!TIMEBASE_hasElapsed(start,period)){}
+}
+/*
+ * Description: Function to add a function called from the timebase interrupt every 1 ms
+ * (must be short , it runs with interrupts disabled)
+ * [out] : TRUE if added or FALSE if TIMEBASE_MAX_HOOKS are already added
+ */
+boolean TIMEBASE_addHook(void(*a_ptr)(void))
+{
+	boolean added=FALSE;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (g_timebase_hooksCount<TIMEBASE_MAX_HOOKS)
+		{
+			g_timebase_hooks[g_timebase_hooksCount]=a_ptr;
+			g_timebase_hooksCount++;
+			added=TRUE;
+		}
+	}
+	return added;
+}
+/*
+ * Description: Function to stop the program (interrupts disabled) on a timebase configuration error
+ * (a hook that isn't added : raise TIMEBASE_MAX_HOOKS)
+ */
+void TIMEBASE_halt(void)
+{
+	ATOMIC_BLOCK(ATOMIC_FORCEON)
+	{
+		while(1){}
+	}
+}
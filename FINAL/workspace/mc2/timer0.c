@@ -114,4 +114,11 @@ void TIMER_0_deInit(void)
 	TCCR0=0; /* no clock and set register as intial value*/
 	TIMSK&=0xfc; /* clear bit 1 and bit 0 */
 }
+/*
+ * Description: Function to change the compare value of timer0 (CTC mode) while it is running
+ */
+void TIMER_0_setCompareValue(uint8 compare_value)
+{
+	OCR0=compare_value;
+}
 
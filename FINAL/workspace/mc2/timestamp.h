@@ -0,0 +1,102 @@
+/******************************************************************************
+ *
+ * Module: timestamp
+ *
+ * File Name: timestamp.h
+ *
+ * Description: Header file for the cycle timestamp driver (timer1 free running)
+ *              and the latency span records
+ *
+ * Author: mahmoud Mohamed
+ *
+ *******************************************************************************/
+#ifndef TIMESTAMP_H_
+#define TIMESTAMP_H_
+/*******************************************************************************
+ *                                includes                                 *
+ *******************************************************************************/
+#include"std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* TRUE : TIMESTAMP_SPAN_BEGIN/END record the spans , FALSE : they compile to nothing */
+#define TIMESTAMP_SPANS_ENABLE        TRUE
+
+/* convert timer1 counts (CPU cycles) to us */
+#define TIMESTAMP_CYCLES_TO_US(cycles) ((cycles)/(F_CPU/1000000UL))
+
+#if (TIMESTAMP_SPANS_ENABLE == TRUE)
+#define TIMESTAMP_SPAN_BEGIN(span)    TIMESTAMP_spanBegin(span)
+#define TIMESTAMP_SPAN_END(span)      TIMESTAMP_spanEnd(span)
+#else
+#define TIMESTAMP_SPAN_BEGIN(span)
+#define TIMESTAMP_SPAN_END(span)
+#endif
+/*******************************************************************************
+ *                         Types Declaration                                   *
+ *******************************************************************************/
+/*******************************************************************************
+ *  Enum name : e_timestamp_span
+ *  Enum Description:
+ *  spans measured in this microcontroller
+ *  TIMESTAMP_SPAN_EEPROM_WRITE      : storing the password in external EEPROM
+ *  TIMESTAMP_SPAN_VERIFY            : comparing the received password with EEPROM
+ *  TIMESTAMP_SPAN_HASH              : salted SHA-256 of a password
+ *  TIMESTAMP_SPAN_TIMEBASE_ISR      : duration of the timebase interrupt (with its hooks)
+ *  TIMESTAMP_SPAN_LINK_CRYPTO       : Ascon encryption or decryption of one link frame
+ *  TIMESTAMP_SPAN_DOOR_OPEN         : door travel from motor_on till the open end stop
+ *  TIMESTAMP_SPAN_DOOR_CLOSE        : door travel from the start of closing till the closed end stop
+ */
+typedef enum
+{
+	TIMESTAMP_SPAN_EEPROM_WRITE,TIMESTAMP_SPAN_VERIFY,TIMESTAMP_SPAN_TIMEBASE_ISR,
+	TIMESTAMP_SPAN_DOOR_OPEN,TIMESTAMP_SPAN_DOOR_CLOSE,TIMESTAMP_SPAN_HASH,
+	TIMESTAMP_SPAN_LINK_CRYPTO,
+	TIMESTAMP_NUM_OF_SPANS
+}e_timestamp_span;
+
+/*******************************************************************************
+ *  Structure name : s_timestamp_SpanRecord
+ *  Structure Description:
+ *  this Structure is responsible for
+ *  1-minimum and maximum span in cycles
+ *  2-sum and count of spans for the average
+ *    (both are halved when sum will overflow so the average follows recent spans)
+ */
+typedef struct
+{
+	uint32 min;
+	uint32 max;
+	uint32 sum;
+	uint16 count;
+}s_timestamp_SpanRecord;
+/*******************************************************************************
+ *                      Functions Prototypes                                   *
+ *******************************************************************************/
+/*
+ *  Description : Function to initialize the timestamp driver
+ * 	1. timer1 normal mode with no prescaler (1 count = 1 CPU cycle)
+ * 	2. enable overflow interrupt to extend the count to 32 bits
+ */
+void TIMESTAMP_init(void);
+/*
+ * Description: Function to return the 32 bit CPU cycle count (wraps after 536 seconds at 8MHZ)
+ */
+uint32 TIMESTAMP_now(void);
+/*
+ * Description: Function to mark the start of a span
+ */
+void TIMESTAMP_spanBegin(e_timestamp_span span);
+/*
+ * Description: Function to mark the end of a span and add it to its record
+ */
+void TIMESTAMP_spanEnd(e_timestamp_span span);
+/*
+ * Description: Function to return the record of a span
+ */
+const s_timestamp_SpanRecord * TIMESTAMP_getRecord(e_timestamp_span span);
+/*
+ * Description: Function to return the average of a span in cycles (0 if not measured yet)
+ */
+uint32 TIMESTAMP_getAverage(e_timestamp_span span);
+#endif /* TIMESTAMP_H_ */
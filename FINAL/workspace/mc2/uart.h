@@ -15,6 +15,15 @@
  *                                includes                                 *
  *******************************************************************************/
 #include "std_types.h"
+/*******************************************************************************
+ *                                 macros                                   *
+ *******************************************************************************/
+/* TRUE : the RX complete interrupt keeps the received bytes in a ring buffer (no overrun while the CPU is busy)
+ * FALSE : UART_recieveByte polls the receiver
+ */
+#define UART_RX_BUFFER_ENABLE     TRUE
+/* size of the ring buffer (power of 2 , holds a whole link frame) */
+#define UART_RX_BUFFER_SIZE       64
 /*******************************************************************************
  *                         Types Declaration                                   *
  *******************************************************************************/
@@ -96,6 +105,7 @@ void UART_sendByte(const uint8 data);
 /*
  * Description :
  * Functional responsible for receive byte from another UART device.
+ * (waits for the next byte of the ring buffer when UART_RX_BUFFER_ENABLE)
  */
 uint8 UART_recieveByte(void);
 /*
@@ -103,6 +113,11 @@ uint8 UART_recieveByte(void);
  * Send the required string through UART to the other UART device.
  */
 void UART_sendString(const uint8 *Str);
+/*
+ * Description :
+ * Send the required string stored in flash (PROGMEM) through UART to the other UART device.
+ */
+void UART_sendString_P(const char *Str);
 /*
  * Description :
  * Receive the required string until the '#' symbol through UART from the other UART device.